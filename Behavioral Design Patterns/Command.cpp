@@ -11,14 +11,54 @@ operations.
 #include <string_view>
 #include <format>
 #include <unordered_map>
+#include <vector>
 #include <memory>
 #include <cassert>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <chrono>
+#include <span>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <optional>
+#include <filesystem>
+#include <fstream>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+using ResourceID = uint32_t;
+
+struct ResourceAccess
+{
+    std::vector<ResourceID> reads;
+    std::vector<ResourceID> writes;
+    bool exclusive = false; // Conflicts with every other command
+};
 
 class Command
 {
 public:
     Command(std::string_view command) :command{ command } {};
     virtual void execute() { std::cout << command << '\n'; };
+    // Resources touched by execute(). Undeclared commands claim exclusive access, so they never get reordered.
+    virtual void declareAccess(ResourceAccess& access) const { access.exclusive = true; }
+    // Parameters written to the journal, and how a replayed record re-runs this command.
+    virtual std::string serialize() const { return {}; }
+    virtual void replay(std::string_view /*payload*/) { this->execute(); }
 protected:
     std::string command;
 };
@@ -35,22 +75,715 @@ protected:
     std::shared_ptr<Command> command = nullptr;
 };
 
+using CommandID = uint32_t; // Dense index handed out by CommandPool::intern()
+
 class CommandPool // Prototype
 {
 public:
-    void addCommand(std::string_view id, std::shared_ptr<Command> command) 
+    CommandID addCommand(std::string_view id, std::shared_ptr<Command> command) 
     {
-        this->commands[id.data()] = command;
+        const CommandID commandID = this->intern(id);
+        this->commands[commandID] = command;
+        this->commandIDs[command.get()] = commandID;
+        return commandID;
     }
 
-    std::shared_ptr<Command>& getCommand(const std::string commandID)
+    CommandID intern(std::string_view name) // Names become dense IDs once, dispatch is an array index afterwards
     {
-        assert(this->commands.find(commandID) != this->commands.end() 
-            && "Nonexistent commmand!");
+        if (auto found = this->ids.find(name); found != this->ids.end()) return found->second;
+        assert(!this->isFrozen() && "A frozen pool cannot learn new names!");
+        const auto commandID = static_cast<CommandID>(this->names.size());
+        this->names.emplace_back(name);
+        this->commands.emplace_back();
+        this->ids.emplace(name, commandID);
+        return commandID;
+    }
+
+    std::optional<CommandID> findID(std::string_view name) const
+    {
+        if (!this->frozenSeeds.empty()) return this->lookUpFrozen(name);
+        if (auto found = this->ids.find(name); found != this->ids.end()) return found->second;
+        return std::nullopt;
+    }
+
+    const std::string& getID(const Command& command) const
+    {
+        assert(this->commandIDs.find(&command) != this->commandIDs.end() && "Command is not pooled!");
+        return this->names[this->commandIDs.at(&command)];
+    }
+
+    const std::string& getName(CommandID commandID) const { return this->names[commandID]; }
+
+    std::shared_ptr<Command>& getCommand(CommandID commandID)
+    {
+        assert(commandID < this->commands.size() && this->commands[commandID] && "Nonexistent commmand!");
         return this->commands[commandID];
     }
+
+    const std::shared_ptr<Command>& getCommand(std::string_view name) // nullptr for unknown names
+    {
+        static const std::shared_ptr<Command> none{};
+        auto commandID = this->findID(name);
+        return commandID ? this->getCommand(*commandID) : none;
+    }
+
+    // Builds a minimal perfect hash (hash and displace) over all names, no more names can be added afterwards.
+    // Names whose hashes collide outright cannot be displaced apart; lookups then stay on the hash map.
+    void freeze()
+    {
+        this->frozen = true;
+        const auto count = static_cast<uint32_t>(this->names.size());
+        const uint32_t bucketCount = std::max<uint32_t>(1, count / 4);
+        std::vector<std::vector<CommandID>> buckets(bucketCount);
+        for (CommandID commandID = 0; commandID < count; ++commandID)
+            buckets[hashName(this->names[commandID]) % bucketCount].emplace_back(commandID);
+
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        this->frozenSeeds.assign(bucketCount, 0);
+        this->frozenSlots.assign(std::max<uint32_t>(count, 1), UINT32_MAX);
+        std::vector<uint32_t> candidates{};
+        for (uint32_t bucket : order) // Largest buckets first, while the table is still mostly empty
+        {
+            if (buckets[bucket].empty()) break;
+            for (uint32_t seed = 1;; ++seed)
+            {
+                if (seed > MaxSeed)
+                {
+                    this->frozenSeeds.clear();
+                    this->frozenSlots.clear();
+                    return;
+                }
+                candidates.clear();
+                for (CommandID commandID : buckets[bucket])
+                {
+                    const uint32_t slot = displace(hashName(this->names[commandID]), seed) % count;
+                    if (this->frozenSlots[slot] != UINT32_MAX || std::find(candidates.begin(), candidates.end(), slot) != candidates.end()) break;
+                    candidates.emplace_back(slot);
+                }
+                if (candidates.size() != buckets[bucket].size()) continue;
+                for (size_t i = 0; i < candidates.size(); ++i)
+                    this->frozenSlots[candidates[i]] = buckets[bucket][i];
+                this->frozenSeeds[bucket] = seed;
+                break;
+            }
+        }
+    }
+
+    bool isFrozen() const { return this->frozen; }
+protected:
+    static constexpr uint32_t MaxSeed = 1 << 16; // Far beyond what a bucket of distinct hashes needs
+
+    struct NameHash // Enables lookups by std::string_view without building a std::string
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return static_cast<size_t>(hashName(name)); }
+    };
+
+    static uint64_t hashName(std::string_view name) // FNV-1a, computed once per lookup
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : name)
+            hash = (hash ^ c) * 1099511628211ull;
+        return hash;
+    }
+
+    static uint32_t displace(uint64_t hash, uint32_t seed) // splitmix64 finalizer over (hash, seed)
+    {
+        uint64_t value = hash + seed * 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<uint32_t>(value ^ (value >> 31));
+    }
+
+    std::optional<CommandID> lookUpFrozen(std::string_view name) const
+    {
+        if (this->names.empty()) return std::nullopt;
+        const uint64_t hash = hashName(name);
+        const uint32_t seed = this->frozenSeeds[hash % this->frozenSeeds.size()];
+        const CommandID commandID = this->frozenSlots[displace(hash, seed) % this->names.size()];
+        if (this->names[commandID] != name) return std::nullopt; // Unknown names land on some slot too
+        return commandID;
+    }
 protected:
-    std::unordered_map<std::string, std::shared_ptr<Command>> commands;
+    std::vector<std::shared_ptr<Command>> commands; // Indexed by CommandID
+    std::vector<std::string> names; // Indexed by CommandID
+    std::unordered_map<std::string, CommandID, NameHash, std::equal_to<>> ids;
+    std::unordered_map<const Command*, CommandID> commandIDs;
+    bool frozen = false;
+    std::vector<uint32_t> frozenSeeds; // Per bucket displacement, empty until freeze() or when it found none
+    std::vector<CommandID> frozenSlots;
+};
+
+class CommandJournal // Write-ahead log of pooled commands: group commit, checksummed records, rotating segments.
+{
+public:
+    struct Options
+    {
+        std::chrono::microseconds groupCommitWindow{ 1000 }; // Longest time a record waits for its fsync
+        size_t maxBatchBytes = 1 << 20; // Commit early once this much is pending
+        size_t segmentBytes = 64 << 20;
+    };
+public:
+    CommandJournal(const std::filesystem::path& directory, CommandPool& pool)
+        :CommandJournal{ directory, pool, Options{} } {};
+    CommandJournal(const std::filesystem::path& directory, CommandPool& pool, Options options)
+        :directory{ directory }, pool{ pool }, options{ options }
+    {
+        std::filesystem::create_directories(directory);
+        for (auto& entry : std::filesystem::directory_iterator{ directory })
+            if (entry.path().extension() == ".wal")
+                this->segments.emplace_back(std::stoull(entry.path().stem().string()));
+        std::sort(this->segments.begin(), this->segments.end());
+        this->recoverTail();
+        this->writer = std::jthread{ [this] { this->commitLoop(); } };
+    }
+    ~CommandJournal()
+    {
+        {
+            std::scoped_lock lock{ this->mutex };
+            this->stopping = true;
+        }
+        this->pendingCV.notify_all();
+        this->writer = std::jthread{}; // Commits whatever is still pending
+        if (this->file) std::fclose(this->file);
+    }
+public:
+    uint64_t append(const Command& command) // Thread-safe, returns the record's sequence number
+    {
+        const std::string& id = this->pool.getID(command);
+        const std::string payload = command.serialize();
+        const uint32_t size = static_cast<uint32_t>(sizeof(uint64_t) + sizeof(uint16_t) + id.size() + payload.size());
+
+        std::unique_lock lock{ this->mutex };
+        const uint64_t sequence = this->nextSequence++;
+        const size_t offset = this->pending.size();
+        this->pending.resize(offset + RecordHeaderSize + size);
+        char* record = this->pending.data() + offset;
+        const auto idSize = static_cast<uint16_t>(id.size());
+        std::memcpy(record, &size, sizeof(size));
+        std::memcpy(record + 8, &sequence, sizeof(sequence));
+        std::memcpy(record + 16, &idSize, sizeof(idSize));
+        std::memcpy(record + 18, id.data(), id.size());
+        std::memcpy(record + 18 + id.size(), payload.data(), payload.size());
+        const uint32_t checksum = crc32(std::string_view{ record + 8, size });
+        std::memcpy(record + 4, &checksum, sizeof(checksum));
+
+        if (offset == 0)
+        {
+            this->pendingFirst = sequence;
+            this->pendingSince = std::chrono::steady_clock::now();
+            this->pendingCV.notify_one();
+        }
+        else if (this->pending.size() >= this->options.maxBatchBytes) this->pendingCV.notify_one();
+        return sequence;
+    }
+
+    bool waitDurable(uint64_t sequence) // False when the journal failed first: the record will never be durable
+    {
+        std::unique_lock lock{ this->mutex };
+        this->durableCV.wait(lock, [&] { return this->durableSequence >= sequence || !this->failure.empty(); });
+        return this->durableSequence >= sequence;
+    }
+
+    std::string getFailure() const // Why writing stopped, empty while the journal is healthy
+    {
+        std::scoped_lock lock{ this->mutex };
+        return this->failure;
+    }
+
+    uint64_t getDurableSequence() const
+    {
+        std::scoped_lock lock{ this->mutex };
+        return this->durableSequence;
+    }
+
+    // Re-executes every durable record after `fromSequence` through the pool, returns how many ran.
+    size_t replay(uint64_t fromSequence = 0)
+    {
+        std::vector<uint64_t> segments{};
+        {
+            std::scoped_lock lock{ this->mutex };
+            segments = this->segments;
+        }
+        size_t replayed = 0, unknown = 0;
+        std::string bytes{};
+        for (uint64_t segment : segments)
+        {
+            readFile(this->segmentPath(segment), bytes);
+            parseRecords(bytes, [&](uint64_t sequence, std::string_view id, std::string_view payload)
+            {
+                if (sequence <= fromSequence) return;
+                const auto commandID = this->pool.findID(id);
+                const auto command = commandID ? this->pool.getCommand(*commandID) : nullptr;
+                if (!command)
+                {
+                    unknown += 1; // Written by a build that had this command
+                    return;
+                }
+                command->replay(payload);
+                replayed += 1;
+            });
+        }
+        if (unknown > 0) std::cerr << std::format("Skipped {} journal records of unknown commands\n", unknown);
+        return replayed;
+    }
+
+    // Drops whole segments that only hold records up to `checkpointSequence` (already captured by a snapshot).
+    size_t compact(uint64_t checkpointSequence)
+    {
+        std::scoped_lock lock{ this->mutex };
+        size_t removed = 0;
+        while (this->segments.size() > 1 && this->segments[1] <= checkpointSequence + 1)
+        {
+            std::filesystem::remove(this->segmentPath(this->segments.front()));
+            this->segments.erase(this->segments.begin());
+            removed += 1;
+        }
+        return removed;
+    }
+
+    uint64_t countCommits() const
+    {
+        std::scoped_lock lock{ this->mutex };
+        return this->commits;
+    }
+
+    size_t countSegments() const
+    {
+        std::scoped_lock lock{ this->mutex };
+        return this->segments.size();
+    }
+private:
+    // [size:u32][crc32:u32] then, covered by the checksum, [sequence:u64][idSize:u16][id][payload]
+    static constexpr size_t RecordHeaderSize = 8;
+
+    template <typename Visitor>
+    static size_t parseRecords(std::string_view bytes, Visitor&& visit) // Returns the length of the valid prefix
+    {
+        size_t offset = 0;
+        while (bytes.size() - offset >= RecordHeaderSize)
+        {
+            uint32_t size = 0, checksum = 0;
+            std::memcpy(&size, bytes.data() + offset, sizeof(size));
+            std::memcpy(&checksum, bytes.data() + offset + 4, sizeof(checksum));
+            if (size < 10 || bytes.size() - offset - RecordHeaderSize < size) break; // Torn write
+            const std::string_view body = bytes.substr(offset + RecordHeaderSize, size);
+            if (crc32(body) != checksum) break;
+
+            uint64_t sequence = 0;
+            uint16_t idSize = 0;
+            std::memcpy(&sequence, body.data(), sizeof(sequence));
+            std::memcpy(&idSize, body.data() + 8, sizeof(idSize));
+            if (10u + idSize > size) break;
+            visit(sequence, body.substr(10, idSize), body.substr(10 + idSize));
+            offset += RecordHeaderSize + size;
+        }
+        return offset;
+    }
+
+    static uint32_t crc32(std::string_view bytes)
+    {
+        static constexpr auto table = []
+        {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                table[i] = value;
+            }
+            return table;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (unsigned char byte : bytes)
+            crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static void readFile(const std::filesystem::path& path, std::string& bytes)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        bytes.resize(std::filesystem::file_size(path));
+        file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    static bool syncFile(std::FILE* file)
+    {
+        if (std::fflush(file) != 0) return false;
+#if defined(_WIN32)
+        return ::_commit(::_fileno(file)) == 0;
+#else
+        return ::fsync(::fileno(file)) == 0;
+#endif
+    }
+
+    bool syncDirectory() const // Makes created, removed and resized segments survive a crash
+    {
+#if defined(_WIN32)
+        return true; // NTFS journals its metadata, and directories cannot be flushed through the C runtime
+#else
+        const int directory = ::open(this->directory.c_str(), O_RDONLY);
+        if (directory < 0) return false;
+        const bool synced = ::fsync(directory) == 0;
+        ::close(directory);
+        return synced;
+#endif
+    }
+
+    std::filesystem::path segmentPath(uint64_t firstSequence) const
+    {
+        return this->directory / std::format("{:020}.wal", firstSequence); // Named after its first record
+    }
+
+    void recoverTail() // Cuts off a torn or corrupt tail left by a crash, and continues the sequence
+    {
+        if (this->segments.empty()) return;
+        const auto path = this->segmentPath(this->segments.back());
+        std::string bytes{};
+        readFile(path, bytes);
+        uint64_t lastSequence = this->segments.back() - 1;
+        const size_t valid = parseRecords(bytes, [&](uint64_t sequence, std::string_view, std::string_view) { lastSequence = sequence; });
+        this->nextSequence = lastSequence + 1;
+        this->durableSequence = lastSequence;
+        this->file = std::fopen(path.string().c_str(), "ab");
+        this->segmentSize = valid;
+        if (valid == bytes.size()) return;
+
+        std::error_code error{};
+        std::filesystem::resize_file(path, valid, error);
+        if (error || !this->file || !syncFile(this->file) || !this->syncDirectory())
+            this->failure = std::format("Failed to truncate the torn tail of {}", path.string());
+    }
+
+    void commitLoop()
+    {
+        std::string batch{};
+        std::unique_lock lock{ this->mutex };
+        for (;;)
+        {
+            this->pendingCV.wait(lock, [this] { return this->stopping || !this->pending.empty(); });
+            if (this->pending.empty()) return;
+            // Let the batch grow until the window closes, unless it is already large enough.
+            this->pendingCV.wait_until(lock, this->pendingSince + this->options.groupCommitWindow,
+                [this] { return this->stopping || this->pending.size() >= this->options.maxBatchBytes; });
+
+            batch.swap(this->pending);
+            const uint64_t batchFirst = this->pendingFirst;
+            const uint64_t batchLast = this->nextSequence - 1;
+            if (!this->failure.empty()) // Nothing after a failed write may become durable, it would leave a gap
+            {
+                batch.clear();
+                continue;
+            }
+            lock.unlock();
+
+            std::string failed{};
+            if (!this->file || (this->segmentSize != 0 && this->segmentSize + batch.size() > this->options.segmentBytes))
+                if (!this->rotate(batchFirst)) failed = std::format("Failed to create journal segment {}", this->segmentPath(batchFirst).string());
+            if (failed.empty() && std::fwrite(batch.data(), 1, batch.size(), this->file) != batch.size()) failed = "Failed to write to the journal";
+            if (failed.empty() && !syncFile(this->file)) failed = "Failed to fsync the journal"; // One fsync for the whole group
+            this->segmentSize += batch.size();
+            batch.clear();
+
+            lock.lock();
+            if (failed.empty())
+            {
+                this->durableSequence = batchLast;
+                this->commits += 1;
+            }
+            else this->failure = failed;
+            this->durableCV.notify_all();
+        }
+    }
+
+    bool rotate(uint64_t firstSequence)
+    {
+        if (this->file) std::fclose(this->file);
+        this->file = std::fopen(this->segmentPath(firstSequence).string().c_str(), "wb");
+        if (!this->file || !this->syncDirectory()) return false;
+        this->segmentSize = 0;
+        std::scoped_lock lock{ this->mutex };
+        this->segments.emplace_back(firstSequence);
+        return true;
+    }
+private:
+    std::filesystem::path directory;
+    CommandPool& pool;
+    Options options;
+    mutable std::mutex mutex;
+    std::condition_variable pendingCV;
+    std::condition_variable durableCV;
+    std::string pending; // Serialized records waiting for the next group commit
+    std::chrono::steady_clock::time_point pendingSince;
+    uint64_t pendingFirst = 0;
+    uint64_t nextSequence = 1;
+    uint64_t durableSequence = 0;
+    uint64_t commits = 0; // Group commits (fsyncs) so far
+    std::string failure; // Set once, after which durableSequence stops advancing
+    std::vector<uint64_t> segments; // First sequence of each segment, oldest first
+    bool stopping = false;
+    // Writer thread only
+    std::FILE* file = nullptr;
+    size_t segmentSize = 0;
+    std::jthread writer;
+};
+
+class UndoableCommand // One executed request that remembers enough to revert itself
+    :public Command
+{
+public:
+    using Command::Command;
+    virtual void undo() = 0;
+    virtual void redo() { this->execute(); }
+    // Absorbs an already executed `next` into this entry, e.g. consecutive keystrokes. Returns false to keep both.
+    virtual bool mergeWith(const UndoableCommand& /*next*/) { return false; }
+    virtual size_t footprint() const { return sizeof(*this) + this->command.capacity(); }
+    // A private copy for the history, since mergeWith() mutates the entry and pooled commands are shared prototypes.
+    virtual std::shared_ptr<UndoableCommand> clone() const = 0;
+};
+
+class UndoHistory
+{
+public:
+    struct Options
+    {
+        std::chrono::milliseconds coalesceWindow{ 500 }; // Mergeable commands closer than this share one entry
+        size_t memoryCap = 16 << 20; // Oldest entries are evicted beyond this many bytes
+    };
+public:
+    UndoHistory() :UndoHistory{ Options{} } {};
+    UndoHistory(Options options) :options{ options } {};
+public:
+    void execute(std::shared_ptr<UndoableCommand> command, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now())
+    {
+        command->execute();
+        this->clearRedo();
+        if (!this->undoStack.empty())
+        {
+            auto& top = this->undoStack.back();
+            if (now - top.lastTouched <= this->options.coalesceWindow && top.command->mergeWith(*command))
+            {
+                this->memory -= top.footprint;
+                top.footprint = top.command->footprint();
+                this->memory += top.footprint;
+                top.lastTouched = now;
+                this->evict();
+                return;
+            }
+        }
+        const size_t footprint = command->footprint();
+        this->undoStack.emplace_back(Entry{ .command = std::move(command), .lastTouched = now, .footprint = footprint });
+        this->memory += footprint;
+        this->evict();
+    }
+
+    bool undo()
+    {
+        if (this->undoStack.empty()) return false;
+        auto entry = std::move(this->undoStack.back());
+        this->undoStack.pop_back();
+        entry.command->undo();
+        entry.lastTouched = {}; // A redone entry never coalesces with what comes next
+        this->redoStack.emplace_back(std::move(entry));
+        this->evict();
+        return true;
+    }
+
+    bool redo()
+    {
+        if (this->redoStack.empty()) return false;
+        auto entry = std::move(this->redoStack.back());
+        this->redoStack.pop_back();
+        entry.command->redo();
+        this->undoStack.emplace_back(std::move(entry));
+        return true;
+    }
+
+    size_t countUndo() const { return this->undoStack.size(); }
+    size_t countRedo() const { return this->redoStack.size(); }
+    size_t getMemory() const { return this->memory; }
+protected:
+    struct Entry
+    {
+        std::shared_ptr<UndoableCommand> command;
+        std::chrono::steady_clock::time_point lastTouched;
+        size_t footprint = 0;
+    };
+
+    void clearRedo()
+    {
+        for (auto& entry : this->redoStack)
+            this->memory -= entry.footprint;
+        this->redoStack.clear();
+    }
+
+    void evict() // Oldest undo entries first, then the redo entries furthest from the present; the newest undo entry always survives
+    {
+        while (this->memory > this->options.memoryCap && this->undoStack.size() > 1)
+        {
+            this->memory -= this->undoStack.front().footprint;
+            this->undoStack.pop_front();
+        }
+        while (this->memory > this->options.memoryCap && !this->redoStack.empty())
+        {
+            this->memory -= this->redoStack.front().footprint;
+            this->redoStack.pop_front();
+        }
+    }
+protected:
+    Options options;
+    std::deque<Entry> undoStack;
+    std::deque<Entry> redoStack; // Next redo at the back
+    size_t memory = 0;
+};
+
+class InsertTextCommand // Typing: consecutive inserts coalesce into one entry
+    :public UndoableCommand
+{
+public:
+    InsertTextCommand(std::string& document, size_t position, std::string_view text)
+        :UndoableCommand{ "insert" }, document{ document }, position{ position }, text{ text } {};
+
+    void execute() override { this->document.insert(this->position, this->text); }
+    void undo() override { this->document.erase(this->position, this->text.size()); }
+    bool mergeWith(const UndoableCommand& next) override
+    {
+        auto* insert = dynamic_cast<const InsertTextCommand*>(&next);
+        if (!insert || &insert->document != &this->document || insert->position != this->position + this->text.size()) return false;
+        this->text += insert->text;
+        return true;
+    }
+    size_t footprint() const override { return sizeof(*this) + this->text.capacity(); }
+    std::shared_ptr<UndoableCommand> clone() const override { return std::make_shared<InsertTextCommand>(*this); }
+protected:
+    std::string& document;
+    size_t position;
+    std::string text;
+};
+
+class WorkStealingPool // Every worker owns a deque: it pops its newest task, idle workers steal the oldest.
+{
+public:
+    using Task = uint32_t;
+    using Body = std::function<void(Task task, std::vector<Task>& ready)>; // Appends the successors it unblocked
+
+    WorkStealingPool(size_t threads) :queues{ std::make_unique<Queue[]>(std::max<size_t>(threads, 1)) }
+    {
+        for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i)
+            this->workers.emplace_back([this, i] { this->work(i); });
+    }
+    ~WorkStealingPool()
+    {
+        {
+            std::scoped_lock lock{ this->batchMutex };
+            this->stopping = true;
+        }
+        this->batchCV.notify_all();
+        this->workers.clear();
+    }
+
+    void run(std::span<const Task> roots, size_t taskCount, const Body& body) // Blocks until taskCount tasks ran
+    {
+        if (taskCount == 0) return;
+        this->body = &body;
+        this->remaining.store(taskCount);
+        for (size_t i = 0; i < roots.size(); ++i)
+            this->push(i % this->workers.size(), roots[i]);
+        {
+            std::scoped_lock lock{ this->batchMutex };
+            this->batch += 1;
+        }
+        this->batchCV.notify_all();
+
+        std::unique_lock lock{ this->doneMutex };
+        this->doneCV.wait(lock, [this] { return this->remaining.load() == 0; });
+    }
+
+    size_t countThreads() const { return this->workers.size(); }
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(size_t worker, Task task)
+    {
+        std::scoped_lock lock{ this->queues[worker].mutex };
+        this->queues[worker].tasks.push_back(task);
+    }
+
+    bool pop(size_t worker, Task& task)
+    {
+        auto& queue = this->queues[worker];
+        std::scoped_lock lock{ queue.mutex };
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task)
+    {
+        for (size_t i = 1; i < this->workers.size(); ++i)
+        {
+            auto& queue = this->queues[(thief + i) % this->workers.size()];
+            std::scoped_lock lock{ queue.mutex };
+            if (queue.tasks.empty()) continue;
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t self)
+    {
+        uint64_t seenBatch = 0;
+        std::vector<Task> ready{};
+        for (;;)
+        {
+            {
+                std::unique_lock lock{ this->batchMutex };
+                this->batchCV.wait(lock, [&] { return this->stopping || this->batch != seenBatch; });
+                if (this->stopping) return;
+                seenBatch = this->batch;
+            }
+            while (this->remaining.load(std::memory_order_acquire) != 0)
+            {
+                Task task = 0;
+                if (!this->pop(self, task) && !this->steal(self, task))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ready.clear();
+                (*this->body)(task, ready);
+                for (Task next : ready)
+                    this->push(self, next);
+                if (this->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::scoped_lock lock{ this->doneMutex };
+                    this->doneCV.notify_all();
+                }
+            }
+        }
+    }
+private:
+    std::unique_ptr<Queue[]> queues;
+    const Body* body = nullptr; // Published to workers through the queue mutexes
+    std::atomic<size_t> remaining{ 0 };
+    std::mutex batchMutex;
+    std::condition_variable batchCV;
+    uint64_t batch = 0;
+    bool stopping = false;
+    std::mutex doneMutex;
+    std::condition_variable doneCV;
+    std::vector<std::jthread> workers; // Declared last, so workers stop before the queues go away
 };
 
 class Invoker
@@ -67,12 +800,444 @@ public:
             command.lock()->execute();
         this->buffer.clear();
     }
+
+    void invoke(UndoHistory& history) // Undoable commands are recorded, the others simply run
+    {
+        for (auto&& command : this->buffer)
+        {
+            auto locked = command.lock();
+            if (auto undoable = std::dynamic_pointer_cast<UndoableCommand>(locked)) history.execute(undoable->clone()); // Leaves the pooled prototype as it is
+            else locked->execute();
+        }
+        this->buffer.clear();
+    }
+
+    void invoke(CommandJournal& journal) // Write-ahead: the whole batch is durable before any of it runs
+    {
+        uint64_t last = 0;
+        for (auto&& command : this->buffer)
+            last = journal.append(*command.lock());
+        if (journal.waitDurable(last))
+        {
+            this->invoke();
+            return;
+        }
+        std::cerr << std::format("{}, the batch was not run\n", journal.getFailure());
+        this->buffer.clear();
+    }
+
+    // Commands that conflict on a resource keep their recorded order, independent ones run in parallel.
+    void invoke(WorkStealingPool& pool)
+    {
+        this->batch.clear();
+        for (auto&& command : this->buffer)
+            this->batch.emplace_back(command.lock());
+        this->buffer.clear();
+        this->buildGraph();
+
+        pool.run(this->roots, this->batch.size(), [this](uint32_t task, std::vector<uint32_t>& ready)
+        {
+            this->batch[task]->execute();
+            for (uint32_t next : this->successors[task])
+                if (this->pendingInputs[next].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    ready.push_back(next);
+        });
+    }
+protected:
+    static constexpr ResourceID World = UINT32_MAX; // Read by every command, written by exclusive ones
+
+    struct ResourceState
+    {
+        uint32_t lastWriter = UINT32_MAX;
+        std::vector<uint32_t> readers; // Since lastWriter
+    };
+
+    void buildGraph() // Read-after-write, write-after-read and write-after-write become edges
+    {
+        const auto count = static_cast<uint32_t>(this->batch.size());
+        if (this->successors.size() < count) this->successors.resize(count);
+        for (uint32_t i = 0; i < count; ++i) this->successors[i].clear();
+        if (this->pendingCapacity < count)
+        {
+            this->pendingInputs = std::make_unique<std::atomic<uint32_t>[]>(count);
+            this->pendingCapacity = count;
+        }
+        for (uint32_t i = 0; i < count; ++i) this->pendingInputs[i].store(0, std::memory_order_relaxed); // Workers see it through the pool's queue mutexes
+        this->resources.clear();
+        this->roots.clear();
+
+        auto depend = [this](uint32_t from, uint32_t to)
+        {
+            this->successors[from].push_back(to);
+            this->pendingInputs[to].fetch_add(1, std::memory_order_relaxed);
+        };
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            this->access.reads.clear();
+            this->access.writes.clear();
+            this->access.exclusive = false;
+            this->batch[i]->declareAccess(this->access);
+            (this->access.exclusive ? this->access.writes : this->access.reads).push_back(World);
+
+            for (ResourceID id : this->access.reads)
+            {
+                auto& resource = this->resources[id];
+                if (resource.lastWriter != UINT32_MAX) depend(resource.lastWriter, i);
+                resource.readers.push_back(i);
+            }
+            for (ResourceID id : this->access.writes)
+            {
+                auto& resource = this->resources[id];
+                if (resource.lastWriter != UINT32_MAX) depend(resource.lastWriter, i);
+                for (uint32_t reader : resource.readers)
+                    if (reader != i) depend(reader, i);
+                resource.readers.clear();
+                resource.lastWriter = i;
+            }
+            if (this->pendingInputs[i].load(std::memory_order_relaxed) == 0) this->roots.push_back(i);
+        }
+    }
 protected:
     std::vector<std::weak_ptr<Command>> buffer;
+    // Per-batch scratch of the parallel path, reused across invocations
+    std::vector<std::shared_ptr<Command>> batch;
+    std::vector<std::vector<uint32_t>> successors;
+    std::unique_ptr<std::atomic<uint32_t>[]> pendingInputs; // Atomics cannot live in a vector, so the capacity is kept by hand
+    uint32_t pendingCapacity = 0;
+    std::vector<uint32_t> roots;
+    std::unordered_map<ResourceID, ResourceState> resources;
+    ResourceAccess access;
 };
 
+class CommandBuffer // Allocation-free Invoker: trivially copyable records are stored inline in a reused arena.
+{
+public:
+    template <typename Record>
+        requires std::is_trivially_copyable_v<Record>
+    void addCommand(const Record& record) // Record must provide `void execute() const`
+    {
+        static_assert(alignof(Record) <= alignof(std::max_align_t), "Over-aligned records are not supported!");
+        constexpr size_t stride = alignUp(sizeof(Header) + sizeof(Record));
+
+        if (this->used + stride > this->arena.size())
+            this->arena.resize(std::max(this->arena.size() * 2, this->used + stride)); // Only while warming up
+        std::byte* slot = this->arena.data() + this->used;
+        const Header header{ .execute = &executeRecord<Record>, .stride = stride };
+        std::memcpy(slot, &header, sizeof(Header));
+        std::memcpy(slot + sizeof(Header), &record, sizeof(Record));
+        this->used += stride;
+        this->count += 1;
+    }
+
+    void invoke() // Linear replay, then rewind: the arena keeps its capacity for the next frame
+    {
+        for (size_t offset = 0; offset < this->used;)
+        {
+            Header header;
+            std::memcpy(&header, this->arena.data() + offset, sizeof(Header));
+            header.execute(this->arena.data() + offset + sizeof(Header));
+            offset += header.stride;
+        }
+        this->used = 0;
+        this->count = 0;
+    }
+
+    size_t size() const { return this->count; }
+    size_t capacity() const { return this->arena.size(); }
+protected:
+    struct Header
+    {
+        void (*execute)(const std::byte* record);
+        size_t stride;
+    };
+
+    template <typename Record>
+    static void executeRecord(const std::byte* bytes) // Records need not be default-constructible: the copy is made from the bytes
+    {
+        alignas(Record) std::byte storage[sizeof(Record)];
+        std::memcpy(storage, bytes, sizeof(Record)); // Implicitly creates the trivially copyable Record, folded away by the optimizer
+        std::launder(reinterpret_cast<const Record*>(storage))->execute();
+    }
+
+    static constexpr size_t alignUp(size_t size)
+    {
+        return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+protected:
+    std::vector<std::byte> arena;
+    size_t used = 0;
+    size_t count = 0;
+};
+
+struct PooledCommand // Bridges pool-owned Commands into CommandBuffer without weak_ptr::lock()
+{
+    Command* command;
+    void execute() const { this->command->execute(); }
+};
+
+struct AddCommand // Parameters live inline in the record, no std::string involved
+{
+    uint64_t* target;
+    uint64_t amount;
+    void execute() const { *this->target += this->amount; }
+};
+
+class AddCounterCommand // The same work as AddCommand behind the Command interface
+    :public Command
+{
+public:
+    AddCounterCommand(uint64_t& target, uint64_t amount)
+        :Command{ "add" }, target{ target }, amount{ amount } {};
+    void execute() override { this->target += this->amount; }
+protected:
+    uint64_t& target;
+    uint64_t amount;
+};
+
+void benchmarkCommandBuffer()
+{
+    constexpr size_t frames = 100;
+    constexpr size_t commandsPerFrame = 100'000;
+    auto report = [](std::string_view name, std::chrono::steady_clock::duration elapsed, uint64_t checksum)
+    {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << std::format("[{}] {:.1f} M commands/s (checksum {})\n", name, frames * commandsPerFrame / seconds / 1e6, checksum);
+    };
+
+    uint64_t counter = 0;
+    std::vector<std::shared_ptr<Command>> commands{};
+    for (uint64_t i = 0; i < 16; ++i)
+        commands.emplace_back(std::make_shared<AddCounterCommand>(counter, i));
+
+    Invoker invoker{};
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (size_t i = 0; i < commandsPerFrame; ++i)
+            invoker.addCommand(commands[i % commands.size()]);
+        invoker.invoke();
+    }
+    report("Invoker weak_ptr", std::chrono::steady_clock::now() - begin, counter);
+
+    counter = 0;
+    CommandBuffer pooledBuffer{};
+    begin = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (size_t i = 0; i < commandsPerFrame; ++i)
+            pooledBuffer.addCommand(PooledCommand{ commands[i % commands.size()].get() });
+        pooledBuffer.invoke();
+    }
+    report("CommandBuffer pooled", std::chrono::steady_clock::now() - begin, counter);
+
+    counter = 0;
+    CommandBuffer inlineBuffer{};
+    begin = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (size_t i = 0; i < commandsPerFrame; ++i)
+            inlineBuffer.addCommand(AddCommand{ &counter, i % commands.size() });
+        inlineBuffer.invoke();
+    }
+    report("CommandBuffer inline", std::chrono::steady_clock::now() - begin, counter);
+}
+
+struct alignas(64) Cell // One resource, padded against false sharing
+{
+    uint64_t value = 0;
+};
+
+class MixCommand // out = mix(out, in), some real work per command
+    :public Command
+{
+public:
+    MixCommand(std::vector<Cell>& cells, ResourceID in, ResourceID out, uint32_t rounds)
+        :Command{ "mix" }, cells{ cells }, in{ in }, out{ out }, rounds{ rounds } {};
+    void execute() override
+    {
+        uint64_t value = this->cells[this->out].value ^ (this->cells[this->in].value + this->out);
+        for (uint32_t i = 0; i < this->rounds; ++i)
+            value = (value ^ (value >> 29)) * 0xbf58476d1ce4e5b9ull + i;
+        this->cells[this->out].value = value;
+    }
+    void declareAccess(ResourceAccess& access) const override
+    {
+        access.reads.push_back(this->in);
+        access.writes.push_back(this->out);
+    }
+protected:
+    std::vector<Cell>& cells;
+    ResourceID in;
+    ResourceID out;
+    uint32_t rounds;
+};
+
+bool checkParallelInvoker(size_t threads) // Parallel invoke() must leave every cell as the serial invoke() does, batch after batch
+{
+    constexpr size_t resources = 64;
+    constexpr size_t batchSizes[] = { 500, 2000, 300, 2000 }; // Growing and shrinking batches through one Invoker
+
+    std::vector<Cell> cells(resources);
+    std::vector<std::shared_ptr<Command>> commands{};
+    uint64_t seed = 7;
+    auto next = [&seed] { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return static_cast<uint32_t>(seed >> 33); };
+    for (size_t i = 0; i < 2000; ++i)
+        commands.emplace_back(std::make_shared<MixCommand>(cells, next() % resources, next() % resources, 16));
+
+    auto runBatches = [&](WorkStealingPool* pool)
+    {
+        std::fill(cells.begin(), cells.end(), Cell{});
+        Invoker invoker{};
+        for (size_t batchSize : batchSizes)
+        {
+            for (size_t i = 0; i < batchSize; ++i)
+                invoker.addCommand(commands[i]);
+            if (pool) invoker.invoke(*pool);
+            else invoker.invoke();
+        }
+        return cells;
+    };
+
+    const std::vector<Cell> expected = runBatches(nullptr);
+    WorkStealingPool pool{ threads };
+    const std::vector<Cell> actual = runBatches(&pool);
+    return std::equal(actual.begin(), actual.end(), expected.begin(), [](const Cell& a, const Cell& b) { return a.value == b.value; });
+}
+
+void benchmarkParallelInvoker() // Scaling plus a determinism check against the serial invoke()
+{
+    constexpr size_t resources = 256;
+    constexpr size_t commandsPerBatch = 20'000;
+    constexpr size_t batches = 20;
+
+    std::vector<Cell> cells(resources);
+    std::vector<std::shared_ptr<Command>> commands{};
+    uint64_t seed = 42;
+    auto next = [&seed] { seed = seed * 6364136223846793005ull + 1442695040888963407ull; return static_cast<uint32_t>(seed >> 33); };
+    for (size_t i = 0; i < commandsPerBatch; ++i)
+        commands.emplace_back(std::make_shared<MixCommand>(cells, next() % resources, next() % resources, 2000));
+
+    auto runBatches = [&](WorkStealingPool* pool)
+    {
+        std::fill(cells.begin(), cells.end(), Cell{});
+        Invoker invoker{};
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t batch = 0; batch < batches; ++batch)
+        {
+            for (auto& command : commands)
+                invoker.addCommand(command);
+            if (pool) invoker.invoke(*pool);
+            else invoker.invoke();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    const double serialSeconds = runBatches(nullptr);
+    const std::vector<Cell> expected = cells;
+    std::cout << std::format("[Serial    ] {:.3f}s\n", serialSeconds);
+    for (size_t threads : { 1, 2, 4, 8, 16 })
+    {
+        WorkStealingPool pool{ threads };
+        const double seconds = runBatches(&pool);
+        const bool deterministic = std::equal(cells.begin(), cells.end(), expected.begin(),
+            [](const Cell& a, const Cell& b) { return a.value == b.value; });
+        std::cout << std::format("[Threads {:>2}] {:.3f}s, speedup {:.2f}x, {}\n",
+            threads, seconds, serialSeconds / seconds, deterministic ? "identical to serial" : "MISMATCH");
+        assert(deterministic && "Parallel invoke diverged from the serial order!");
+    }
+}
+
+void benchmarkJournal() // Durable commands per second for several group-commit windows
+{
+    constexpr size_t producers = 32;
+    const auto duration = std::chrono::seconds{ 1 };
+    const auto directory = std::filesystem::temp_directory_path() / "command-journal-bench";
+
+    CommandPool pool{};
+    auto command = std::make_shared<Command>("noop");
+    pool.addCommand("noop", command);
+
+    for (auto window : { 0, 100, 1000, 5000 })
+    {
+        std::filesystem::remove_all(directory);
+        std::atomic<uint64_t> committed = 0;
+        uint64_t fsyncs = 0;
+        {
+            CommandJournal journal{ directory, pool, CommandJournal::Options{ .groupCommitWindow = std::chrono::microseconds{ window } } };
+            const auto deadline = std::chrono::steady_clock::now() + duration;
+            std::vector<std::jthread> threads{};
+            for (size_t i = 0; i < producers; ++i)
+                threads.emplace_back([&]
+                {
+                    while (std::chrono::steady_clock::now() < deadline)
+                    {
+                        journal.waitDurable(journal.append(*command));
+                        committed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+            threads.clear();
+            fsyncs = journal.countCommits();
+        }
+        std::cout << std::format("[Window {:>4}us] {:.0f} durable commands/s, {:.1f} commands per fsync\n",
+            window, committed.load() / std::chrono::duration<double>(duration).count(), committed.load() / static_cast<double>(std::max<uint64_t>(fsyncs, 1)));
+    }
+    std::filesystem::remove_all(directory);
+}
+
+void benchmarkCommandLookup() // Name and ID lookups over 10k commands
+{
+    constexpr size_t commandCount = 10'000;
+    constexpr size_t lookups = 10'000'000;
+
+    CommandPool pool{};
+    std::unordered_map<std::string, std::shared_ptr<Command>> stringMap{}; // The former getCommand() path
+    std::vector<std::string> names{};
+    for (size_t i = 0; i < commandCount; ++i)
+    {
+        names.emplace_back(std::format("editor.command.{}", i * 7919));
+        auto command = std::make_shared<Command>(names.back());
+        pool.addCommand(names.back(), command);
+        stringMap[names.back()] = command;
+    }
+    std::vector<uint32_t> order(lookups);
+    uint64_t seed = 7;
+    for (auto& index : order)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        index = static_cast<uint32_t>((seed >> 33) % commandCount);
+    }
+
+    auto measure = [&](std::string_view name, auto&& lookUp)
+    {
+        uintptr_t checksum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (uint32_t index : order)
+            checksum += reinterpret_cast<uintptr_t>(lookUp(index));
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+        std::cout << std::format("[{:<24}] {:.1f} ns/lookup (checksum {})\n", name, elapsed.count() / lookups, checksum % 1000);
+    };
+
+    measure("unordered_map<string>", [&](uint32_t i) { return stringMap[std::string{ names[i] }].get(); });
+    measure("Interned name", [&](uint32_t i) { return pool.getCommand(std::string_view{ names[i] }).get(); });
+    auto begin = std::chrono::steady_clock::now();
+    pool.freeze();
+    std::chrono::duration<double, std::milli> freezing = std::chrono::steady_clock::now() - begin;
+    std::cout << std::format("[Freeze {} names] {:.2f} ms\n", commandCount, freezing.count());
+    measure("Perfect hash name", [&](uint32_t i) { return pool.getCommand(std::string_view{ names[i] }).get(); });
+    measure("CommandID", [&](uint32_t i) { return pool.getCommand(CommandID{ i }).get(); });
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkCommandLookup();
+        benchmarkCommandBuffer();
+        benchmarkParallelInvoker();
+        benchmarkJournal();
+        return EXIT_SUCCESS;
+    }
+
     CommandPool commandPool{};
     commandPool.addCommand("copy", std::make_shared<Command>("Copy something!"));
     commandPool.addCommand("redo", std::make_shared<Command>("Redo something!"));
@@ -85,6 +1250,51 @@ int main(int argc, char* argv[])
 
     commandBuffer.invoke();
 
+    WorkStealingPool pool{ 2 };
+    commandBuffer.addCommand(commandPool.getCommand("copy"));
+    commandBuffer.addCommand(commandPool.getCommand("redo")); // Undeclared commands keep their order
+    commandBuffer.invoke(pool);
+    for (size_t threads : { size_t{ 1 }, size_t{ 2 }, std::max<size_t>(std::thread::hardware_concurrency(), 3) })
+        std::cout << std::format("Parallel invoke of conflicting commands on {} thread(s): {}\n", threads, checkParallelInvoker(threads) ? "identical to serial" : "MISMATCH");
+
+    const auto journalDirectory = std::filesystem::temp_directory_path() / "command-journal-demo";
+    std::filesystem::remove_all(journalDirectory);
+    {
+        CommandJournal journal{ journalDirectory, commandPool };
+        commandBuffer.addCommand(commandPool.getCommand("copy"));
+        commandBuffer.addCommand(commandPool.getCommand("redo"));
+        commandBuffer.invoke(journal);
+    }
+    {
+        CommandJournal journal{ journalDirectory, commandPool }; // After a restart
+        const size_t replayed = journal.replay();
+        std::cout << std::format("Replayed {} commands from the journal\n", replayed);
+    }
+    std::filesystem::remove_all(journalDirectory);
+
+    std::string document{};
+    UndoHistory history{ UndoHistory::Options{ .coalesceWindow = std::chrono::milliseconds{ 500 } } };
+    auto typingTime = std::chrono::steady_clock::now();
+    for (std::string_view word : { "Hello", ",", " World" }) // One burst of typing
+    {
+        history.execute(std::make_shared<InsertTextCommand>(document, document.size(), word), typingTime);
+        typingTime += std::chrono::milliseconds{ 100 };
+    }
+    typingTime += std::chrono::seconds{ 2 };
+    history.execute(std::make_shared<InsertTextCommand>(document, document.size(), "!"), typingTime);
+    std::cout << std::format("{} ({} history entries)\n", document, history.countUndo());
+    history.undo();
+    std::cout << std::format("Undo: {}\n", document);
+    history.undo();
+    std::cout << std::format("Undo: \"{}\"\n", document);
+    history.redo();
+    std::cout << std::format("Redo: {}\n", document);
+
+    CommandBuffer recordBuffer{}; // Same requests, recorded inline
+    recordBuffer.addCommand(PooledCommand{ commandPool.getCommand("copy").get() });
+    recordBuffer.addCommand(PooledCommand{ commandPool.getCommand("redo").get() });
+    recordBuffer.invoke();
+
     return EXIT_SUCCESS;
 }
 
@@ -13,20 +13,303 @@ the details of its implementation.
 #include <chrono>
 using namespace std::chrono_literals;
 #include <stack>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstring>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <cstdio>
+#include <cassert>
+#include <utility>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+class PersistentText // Immutable rope of shared chunks: copies are O(1), edits path-copy O(log n) nodes
+{
+public:
+    PersistentText() = default;
+    PersistentText(std::string_view text) :root{ build(text) } {};
+    PersistentText& operator=(std::string_view text)
+    {
+        this->root = build(text);
+        return *this;
+    }
+public:
+    size_t size() const { return this->root ? this->root->size : 0; }
+    bool empty() const { return this->size() == 0; }
+
+    char operator[](size_t index) const
+    {
+        const Node* node = this->root.get();
+        while (!node->isLeaf())
+        {
+            if (index < node->left->size) node = node->left.get();
+            else
+            {
+                index -= node->left->size;
+                node = node->right.get();
+            }
+        }
+        return node->chunk[index];
+    }
+
+    std::string substr(size_t offset, size_t count) const
+    {
+        std::string result{};
+        offset = std::min(offset, this->size());
+        count = std::min(count, this->size() - offset);
+        result.reserve(count);
+        if (count != 0) appendRange(*this->root, offset, count, result);
+        return result;
+    }
+
+    std::string str() const { return this->substr(0, this->size()); }
+
+    void replace(size_t offset, size_t count, std::string_view text)
+    {
+        offset = std::min(offset, this->size());
+        count = std::min(count, this->size() - offset);
+        if (!this->root) this->root = build(text);
+        else if (auto patched = replaceInLeaf(this->root, offset, count, text)) this->root = patched; // Common case: a small edit
+        else this->root = concat(concat(prefix(this->root, offset), build(text)), suffix(this->root, offset + count));
+        if (this->root && this->root->depth > MaxDepth) this->root = rebalance(this->root);
+    }
+
+    template <typename Visitor> // Visitor(std::string_view chunk) returns false to stop
+    bool visitChunks(Visitor&& visit) const { return !this->root || visitForward(*this->root, visit); }
+    template <typename Visitor>
+    bool visitChunksReverse(Visitor&& visit) const { return !this->root || visitBackward(*this->root, visit); }
+
+    static size_t liveBytes() { return Node::liveBytes.load(std::memory_order_relaxed); } // All ropes together, shared chunks counted once
+
+    // Lengths of the common prefix and (non-overlapping) suffix. Subtrees both ropes share are skipped unread,
+    // so comparing two snapshots of one history costs O(log n) plus the edited chunks.
+    static std::pair<size_t, size_t> commonAffixes(const PersistentText& a, const PersistentText& b)
+    {
+        if (!a.root || !b.root) return { 0, 0 };
+        const size_t limit = std::min(a.size(), b.size());
+        const size_t prefix = matchLength(a.root, b.root, limit, false);
+        return { prefix, matchLength(a.root, b.root, limit - prefix, true) };
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const PersistentText& text)
+    {
+        text.visitChunks([&](std::string_view chunk) { os << chunk; return true; });
+        return os;
+    }
+private:
+    static constexpr size_t ChunkSize = 1024;
+    static constexpr int MaxDepth = 48;
+
+    struct Node
+    {
+        Node(std::string chunk) :size{ chunk.size() }, chunk{ std::move(chunk) } { liveBytes.fetch_add(this->footprint(), std::memory_order_relaxed); }
+        Node(std::shared_ptr<const Node> left, std::shared_ptr<const Node> right)
+            :size{ left->size + right->size }, depth{ 1 + std::max(left->depth, right->depth) },
+            left{ std::move(left) }, right{ std::move(right) } { liveBytes.fetch_add(this->footprint(), std::memory_order_relaxed); }
+        ~Node() { liveBytes.fetch_sub(this->footprint(), std::memory_order_relaxed); }
+
+        bool isLeaf() const { return !this->left; }
+        size_t footprint() const { return sizeof(Node) + this->chunk.capacity(); }
+
+        size_t size = 0;
+        int depth = 0;
+        std::string chunk; // Leaves only
+        std::shared_ptr<const Node> left;
+        std::shared_ptr<const Node> right;
+        static inline std::atomic<size_t> liveBytes = 0; // Nodes may be released on the history compressor thread
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+
+    static NodePtr build(std::string_view text) // Balanced tree over ChunkSize leaves
+    {
+        if (text.empty()) return nullptr;
+        if (text.size() <= ChunkSize) return std::make_shared<const Node>(std::string{ text });
+        const size_t leaves = (text.size() + ChunkSize - 1) / ChunkSize;
+        const size_t middle = leaves / 2 * ChunkSize;
+        return std::make_shared<const Node>(build(text.substr(0, middle)), build(text.substr(middle)));
+    }
+
+    static NodePtr concat(NodePtr left, NodePtr right)
+    {
+        if (!left) return right;
+        if (!right) return left;
+        if (left->isLeaf() && right->isLeaf() && left->size + right->size <= ChunkSize)
+            return std::make_shared<const Node>(left->chunk + right->chunk);
+        return std::make_shared<const Node>(std::move(left), std::move(right));
+    }
+
+    static NodePtr prefix(const NodePtr& node, size_t count) // First `count` characters, sharing whole subtrees
+    {
+        if (count == 0) return nullptr;
+        if (count >= node->size) return node;
+        if (node->isLeaf()) return std::make_shared<const Node>(node->chunk.substr(0, count));
+        if (count <= node->left->size) return prefix(node->left, count);
+        return concat(node->left, prefix(node->right, count - node->left->size));
+    }
+
+    static NodePtr suffix(const NodePtr& node, size_t offset) // Everything from `offset` on
+    {
+        if (offset == 0) return node;
+        if (offset >= node->size) return nullptr;
+        if (node->isLeaf()) return std::make_shared<const Node>(node->chunk.substr(offset));
+        if (offset >= node->left->size) return suffix(node->right, offset - node->left->size);
+        return concat(suffix(node->left, offset), node->right);
+    }
+
+    static NodePtr replaceInLeaf(const NodePtr& node, size_t offset, size_t count, std::string_view text)
+    {
+        if (node->isLeaf())
+        {
+            std::string chunk = node->chunk;
+            chunk.replace(offset, count, text);
+            if (chunk.size() > 2 * ChunkSize) return build(chunk);
+            return chunk.empty() ? nullptr : std::make_shared<const Node>(std::move(chunk));
+        }
+        const size_t leftSize = node->left->size;
+        if (offset + count <= leftSize && (offset < leftSize || count > 0 || text.empty()))
+        {
+            auto left = replaceInLeaf(node->left, offset, count, text);
+            return left ? std::make_shared<const Node>(std::move(left), node->right) : nullptr;
+        }
+        if (offset >= leftSize)
+        {
+            auto right = replaceInLeaf(node->right, offset - leftSize, count, text);
+            return right ? std::make_shared<const Node>(node->left, std::move(right)) : nullptr;
+        }
+        return nullptr; // Spans both children, take the general path
+    }
+
+    static void appendRange(const Node& node, size_t offset, size_t count, std::string& out) // Skips untouched subtrees
+    {
+        if (node.isLeaf())
+        {
+            out.append(node.chunk, offset, count);
+            return;
+        }
+        const size_t leftSize = node.left->size;
+        if (offset < leftSize)
+        {
+            const size_t taken = std::min(count, leftSize - offset);
+            appendRange(*node.left, offset, taken, out);
+            if (taken < count) appendRange(*node.right, 0, count - taken, out);
+        }
+        else appendRange(*node.right, offset - leftSize, count, out);
+    }
+
+    static size_t matchLength(const NodePtr& rootA, const NodePtr& rootB, size_t limit, bool backward)
+    {
+        std::vector<const Node*> pendingA{ rootA.get() }, pendingB{ rootB.get() }; // Next subtree in scan order on top
+        auto descend = [backward](std::vector<const Node*>& pending)
+        {
+            const Node* node = pending.back();
+            pending.pop_back();
+            pending.emplace_back(backward ? node->left.get() : node->right.get());
+            pending.emplace_back(backward ? node->right.get() : node->left.get());
+        };
+        size_t matched = 0, offsetA = 0, offsetB = 0; // Offsets count consumed characters of a leaf on top
+        while (matched < limit && !pendingA.empty() && !pendingB.empty())
+        {
+            const Node* x = pendingA.back();
+            const Node* y = pendingB.back();
+            if (x == y && offsetA == 0 && offsetB == 0 && x->size <= limit - matched)
+            {
+                matched += x->size; // The very same subtree
+                pendingA.pop_back();
+                pendingB.pop_back();
+                continue;
+            }
+            if (!x->isLeaf()) { descend(pendingA); continue; }
+            if (!y->isLeaf()) { descend(pendingB); continue; }
+
+            const std::string_view chunkA = x->chunk, chunkB = y->chunk;
+            const size_t n = std::min({ chunkA.size() - offsetA, chunkB.size() - offsetB, limit - matched });
+            const size_t same = backward
+                ? std::mismatch(chunkA.rbegin() + offsetA, chunkA.rbegin() + offsetA + n, chunkB.rbegin() + offsetB).first - (chunkA.rbegin() + offsetA)
+                : std::mismatch(chunkA.begin() + offsetA, chunkA.begin() + offsetA + n, chunkB.begin() + offsetB).first - (chunkA.begin() + offsetA);
+            matched += same;
+            if (same < n) break;
+            offsetA += n, offsetB += n;
+            if (offsetA == chunkA.size()) pendingA.pop_back(), offsetA = 0;
+            if (offsetB == chunkB.size()) pendingB.pop_back(), offsetB = 0;
+        }
+        return matched;
+    }
+
+    static void collectLeaves(const NodePtr& node, std::vector<NodePtr>& leaves)
+    {
+        if (node->isLeaf()) leaves.emplace_back(node);
+        else
+        {
+            collectLeaves(node->left, leaves);
+            collectLeaves(node->right, leaves);
+        }
+    }
+
+    static NodePtr buildBalanced(std::span<const NodePtr> leaves)
+    {
+        if (leaves.size() == 1) return leaves.front();
+        const size_t middle = leaves.size() / 2;
+        return std::make_shared<const Node>(buildBalanced(leaves.first(middle)), buildBalanced(leaves.subspan(middle)));
+    }
+
+    static NodePtr rebalance(const NodePtr& node) // Relinks the existing leaves, no text is copied
+    {
+        std::vector<NodePtr> leaves{};
+        collectLeaves(node, leaves);
+        return buildBalanced(leaves);
+    }
+
+    template <typename Visitor>
+    static bool visitForward(const Node& node, Visitor& visit)
+    {
+        if (node.isLeaf()) return visit(std::string_view{ node.chunk });
+        return visitForward(*node.left, visit) && visitForward(*node.right, visit);
+    }
+
+    template <typename Visitor>
+    static bool visitBackward(const Node& node, Visitor& visit)
+    {
+        if (node.isLeaf()) return visit(std::string_view{ node.chunk });
+        return visitBackward(*node.right, visit) && visitBackward(*node.left, visit);
+    }
+private:
+    NodePtr root;
+};
 
 class EditorUser;
+class DeltaEditorUser;
+class TieredEditorUser;
+class TimeTravelEditorUser;
 
 class Editor
 {
     friend EditorUser;
+    friend DeltaEditorUser;
+    friend TieredEditorUser;
+    friend TimeTravelEditorUser;
 private:
     struct State
     {
-        std::string text;
+        PersistentText text; // Copying a State shares the text instead of duplicating it
         std::string font;
         friend std::ostream& operator<<(std::ostream& os, const State& state)
         {
-            os << std::format("Text: {}\nFont: {}\n", state.text, state.font);
+            os << std::format("Text: {}\nFont: {}\n", state.text.str(), state.font);
             return os;
         }
     };
@@ -40,6 +323,7 @@ public:
             :snapshot{ state }, 
             record_time{ std::chrono::system_clock::now() }
         {}
+        std::chrono::system_clock::time_point getRecordTime() const { return this->record_time; }
     private:
         State snapshot;
         std::chrono::system_clock::time_point record_time;
@@ -54,6 +338,110 @@ public:
     {
         this->state = memo.snapshot;
     }
+
+    // Serializes `older` as the edit that turns `base` back into it, for history kept outside of memory.
+    static std::string encodeSnapshot(const Memento& older, const Memento& base)
+    {
+        const auto& from = base.snapshot.text;
+        const auto& to = older.snapshot.text;
+        const auto [prefix, suffix] = PersistentText::commonAffixes(from, to);
+        const std::string replacement = to.substr(prefix, to.size() - prefix - suffix);
+        const uint64_t header[] = { prefix, from.size() - prefix - suffix, older.snapshot.font.size(),
+            static_cast<uint64_t>(older.record_time.time_since_epoch().count()) };
+
+        std::string bytes(sizeof(header), '\0');
+        std::memcpy(bytes.data(), header, sizeof(header));
+        bytes += older.snapshot.font;
+        bytes += replacement;
+        return bytes;
+    }
+
+    static Memento decodeSnapshot(std::string_view bytes, const Memento& base)
+    {
+        uint64_t header[4]{};
+        std::memcpy(header, bytes.data(), sizeof(header));
+        bytes.remove_prefix(sizeof(header));
+
+        Memento memo{ base.snapshot }; // Shares everything the edit did not touch
+        memo.snapshot.font = bytes.substr(0, header[2]);
+        memo.snapshot.text.replace(header[0], header[1], bytes.substr(header[2]));
+        memo.record_time = std::chrono::system_clock::time_point{ std::chrono::system_clock::duration{ header[3] } };
+        return memo;
+    }
+private:
+    struct Delta // Reverse edit: putting `removed` back over [offset, offset + insertedSize) yields the older string
+    {
+        size_t offset = 0;
+        size_t insertedSize = 0;
+        std::string removed;
+
+        template <typename Text>
+        void revert(Text& newer) const { newer.replace(this->offset, this->insertedSize, this->removed); }
+    };
+public:
+    class DeltaMemento // Only what one edit replaced, plus an occasional full checkpoint of the result
+    {
+        friend Editor;
+    public:
+        DeltaMemento() = delete;
+        size_t footprint() const
+        {
+            return sizeof(*this) + this->text.removed.capacity() + this->font.removed.capacity()
+                + (this->checkpoint ? sizeof(State) + this->checkpoint->font.capacity() : 0); // Checkpoint text is shared
+        }
+        bool hasCheckpoint() const { return this->checkpoint != nullptr; }
+    private:
+        DeltaMemento(Delta text, Delta font)
+            :text{ std::move(text) }, font{ std::move(font) },
+            record_time{ std::chrono::system_clock::now() }
+        {}
+    private:
+        Delta text;
+        Delta font;
+        std::shared_ptr<const State> checkpoint; // State right after this edit
+        std::chrono::system_clock::time_point record_time;
+    };
+public:
+    // Ranged edits hand back a delta memento, so history costs O(edit) rather than O(document).
+    DeltaMemento replaceText(size_t offset, size_t count, std::string_view text)
+    {
+        offset = std::min(offset, this->state.text.size());
+        count = std::min(count, this->state.text.size() - offset);
+        Delta delta{ .offset = offset, .insertedSize = text.size(), .removed = this->state.text.substr(offset, count) };
+        this->state.text.replace(offset, count, text);
+        return DeltaMemento{ std::move(delta), Delta{} };
+    }
+
+    DeltaMemento setFont(std::string_view font)
+    {
+        Delta delta{ .offset = 0, .insertedSize = font.size(), .removed = this->state.font };
+        this->state.font = font;
+        return DeltaMemento{ Delta{}, std::move(delta) };
+    }
+
+    void attachCheckpoint(DeltaMemento& memo) const
+    {
+        memo.checkpoint = std::make_shared<const State>(this->state);
+    }
+
+    // Undoes `newest` back to the state before `oldest` edit (both inclusive, newest first).
+    // A checkpoint inside the range short-cuts the walk, so restore time stays bounded by the checkpoint interval.
+    void restoreFromDeltas(std::span<const DeltaMemento> history, size_t oldest)
+    {
+        size_t newest = history.size(); // One past the memento to revert first
+        for (size_t i = oldest; i + 1 < history.size(); ++i) // The newest entry's checkpoint equals the current state
+            if (history[i].checkpoint)
+            {
+                this->state = *history[i].checkpoint;
+                newest = i + 1;
+                break;
+            }
+        for (size_t i = newest; i-- > oldest;)
+        {
+            history[i].font.revert(this->state.font);
+            history[i].text.revert(this->state.text);
+        }
+    }
 protected:
     State state;
 };
@@ -75,6 +463,11 @@ public:
         saveMemento();
         this->editor.state.font = font;
     }
+    void replaceText(size_t offset, size_t count, std::string_view text)
+    {
+        saveMemento();
+        this->editor.state.text.replace(offset, count, text);
+    }
     void undo()
     {
         if (this->histories.empty())
@@ -95,8 +488,817 @@ protected:
     std::stack<Editor::Memento> histories;
 };
 
+class DeltaEditorUser // EditorUser with delta mementos and a full checkpoint every `checkpointInterval` edits
+{
+public:
+    DeltaEditorUser() = delete;
+    DeltaEditorUser(Editor& editor, size_t checkpointInterval = 1000)
+        :editor{ editor }, checkpointInterval{ std::max<size_t>(checkpointInterval, 1) } {};
+public:
+    const Editor::State& getState() const { return this->editor.state; }
+    void setText(std::string_view text) // Only the range between the common prefix and suffix is recorded
+    {
+        const PersistentText& old = this->editor.state.text;
+        const size_t common = std::min(old.size(), text.size());
+        size_t prefix = 0;
+        old.visitChunks([&](std::string_view chunk)
+        {
+            const size_t length = std::min(chunk.size(), common - prefix);
+            const size_t same = std::mismatch(chunk.begin(), chunk.begin() + length, text.begin() + prefix).first - chunk.begin();
+            prefix += same;
+            return same == chunk.size() && prefix < common;
+        });
+        size_t suffix = 0;
+        old.visitChunksReverse([&](std::string_view chunk)
+        {
+            const size_t length = std::min(chunk.size(), common - prefix - suffix);
+            const size_t same = std::mismatch(chunk.rbegin(), chunk.rbegin() + length, text.rbegin() + suffix).first - chunk.rbegin();
+            suffix += same;
+            return same == chunk.size() && prefix + suffix < common;
+        });
+        this->replaceText(prefix, old.size() - prefix - suffix, text.substr(prefix, text.size() - prefix - suffix));
+    }
+    void replaceText(size_t offset, size_t count, std::string_view text)
+    {
+        this->record(this->editor.replaceText(offset, count, text));
+    }
+    void setFont(std::string_view font)
+    {
+        this->record(this->editor.setFont(font));
+    }
+    void undo(size_t steps = 1)
+    {
+        if (this->histories.empty())
+        {
+            std::cerr << "No histories!\n";
+            return;
+        }
+        const size_t oldest = this->histories.size() - std::min(steps, this->histories.size());
+        this->editor.restoreFromDeltas(this->histories, oldest);
+        for (size_t i = oldest; i < this->histories.size(); ++i)
+            this->memory -= this->histories[i].footprint();
+        this->histories.erase(this->histories.begin() + oldest, this->histories.end());
+    }
+    size_t getMemory() const { return this->memory; }
+protected:
+    void record(Editor::DeltaMemento memo)
+    {
+        if ((this->histories.size() + 1) % this->checkpointInterval == 0)
+            this->editor.attachCheckpoint(memo);
+        this->memory += memo.footprint();
+        this->histories.emplace_back(std::move(memo));
+    }
+protected:
+    Editor& editor;
+    size_t checkpointInterval;
+    std::vector<Editor::DeltaMemento> histories;
+    size_t memory = 0;
+};
+
+class HistoryCodec // Byte-oriented LZ77: [literal count][literals][match length][distance]..., varint encoded
+{
+public:
+    static std::string compress(std::string_view input)
+    {
+        std::string output{};
+        std::vector<uint32_t> table(1 << 14, UINT32_MAX); // Last position of each 4-byte hash
+        size_t literalStart = 0;
+        size_t position = 0;
+        while (position + MinMatch <= input.size())
+        {
+            uint32_t word = 0;
+            std::memcpy(&word, input.data() + position, sizeof(word));
+            const uint32_t hash = (word * 2654435761u) >> 18;
+            const uint32_t candidate = std::exchange(table[hash], static_cast<uint32_t>(position));
+            if (candidate == UINT32_MAX || std::memcmp(input.data() + candidate, input.data() + position, MinMatch) != 0)
+            {
+                position += 1;
+                continue;
+            }
+            size_t length = MinMatch;
+            while (position + length < input.size() && input[candidate + length] == input[position + length]) ++length;
+
+            writeVarint(output, position - literalStart);
+            output.append(input.substr(literalStart, position - literalStart));
+            writeVarint(output, length);
+            writeVarint(output, position - candidate);
+            position += length;
+            literalStart = position;
+        }
+        writeVarint(output, input.size() - literalStart);
+        output.append(input.substr(literalStart));
+        writeVarint(output, 0); // End of stream
+        return output;
+    }
+
+    static std::string decompress(std::string_view input)
+    {
+        std::string output{};
+        for (;;)
+        {
+            const size_t literals = readVarint(input);
+            output.append(input.substr(0, literals));
+            input.remove_prefix(literals);
+            const size_t length = readVarint(input);
+            if (length == 0) return output;
+            const size_t from = output.size() - readVarint(input);
+            for (size_t i = 0; i < length; ++i) // Byte by byte, matches may overlap their own output
+                output.push_back(output[from + i]);
+        }
+    }
+private:
+    static constexpr size_t MinMatch = 4;
+
+    static void writeVarint(std::string& output, uint64_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            output.push_back(static_cast<char>(value | 0x80));
+        output.push_back(static_cast<char>(value));
+    }
+
+    static uint64_t readVarint(std::string_view& input)
+    {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            const auto byte = static_cast<uint8_t>(input.front());
+            input.remove_prefix(1);
+            value |= uint64_t{ byte & 0x7Fu } << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+};
+
+class SpillFile // Append-only file of records, read back through a read-only memory mapping
+{
+public:
+    SpillFile(std::filesystem::path path) :path{ path.empty() ? uniquePath() : std::move(path) }
+    {
+        this->file = std::fopen(this->path.string().c_str(), "w+b"); // Without a file every append fails and records stay in RAM
+    }
+    ~SpillFile()
+    {
+        this->unmap();
+        if (!this->file) return;
+        std::fclose(this->file);
+        std::filesystem::remove(this->path);
+    }
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+public:
+    static std::filesystem::path uniquePath() // One file per process and instance, so stores never truncate or delete each other's
+    {
+        static std::atomic<uint64_t> counter{ 0 };
+#if defined(_WIN32)
+        const unsigned long process = ::GetCurrentProcessId();
+#else
+        const long process = static_cast<long>(::getpid());
+#endif
+        return std::filesystem::temp_directory_path() / std::format("editor-history-{}-{}.spill", process, counter++);
+    }
+
+    std::optional<uint64_t> append(std::string_view bytes) // The record offset, nullopt when the write failed (e.g. a full disk)
+    {
+        if (!this->file) return std::nullopt;
+        const uint64_t offset = this->size;
+        if (std::fseek(this->file, static_cast<long>(offset), SEEK_SET) != 0 // Overwrites records that were popped
+            || std::fwrite(bytes.data(), 1, bytes.size(), this->file) != bytes.size() || std::fflush(this->file) != 0)
+        {
+            std::clearerr(this->file);
+            return std::nullopt; // The size is unchanged, so the partial record is overwritten later
+        }
+        this->size += bytes.size();
+        return offset;
+    }
+
+    std::string_view read(uint64_t offset, size_t length)
+    {
+        if (offset + length > this->mappedSize) this->map();
+        return std::string_view{ this->mapped + offset, length };
+    }
+
+    void truncate(uint64_t size) { this->size = size; } // Records form a stack, so the tail is simply reused
+    uint64_t getSize() const { return this->size; }
+private:
+    void map()
+    {
+        this->unmap();
+        const uint64_t fileSize = std::filesystem::file_size(this->path);
+#if defined(_WIN32)
+        auto handle = reinterpret_cast<HANDLE>(::_get_osfhandle(::_fileno(this->file)));
+        this->mapping = ::CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        this->mapped = static_cast<const char*>(::MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        void* view = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, ::fileno(this->file), 0);
+        this->mapped = view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+#endif
+        assert(this->mapped && "Failed to map the spill file!");
+        this->mappedSize = fileSize;
+    }
+
+    void unmap()
+    {
+        if (!this->mapped) return;
+#if defined(_WIN32)
+        ::UnmapViewOfFile(this->mapped);
+        ::CloseHandle(this->mapping);
+#else
+        ::munmap(const_cast<char*>(this->mapped), this->mappedSize);
+#endif
+        this->mapped = nullptr;
+        this->mappedSize = 0;
+    }
+private:
+    std::filesystem::path path;
+    std::FILE* file = nullptr;
+    uint64_t size = 0;
+    const char* mapped = nullptr;
+    uint64_t mappedSize = 0;
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+#endif
+};
+
+class TieredHistoryStore // Hot mementos in RAM, older ones compressed in the background, the oldest on disk
+{
+public:
+    struct Options
+    {
+        size_t hotEntries = 64; // Newest mementos kept as they are (they share text with the document)
+        size_t memoryBudget = 32 << 20; // Compressed bytes kept in RAM before spilling to disk
+        std::filesystem::path spillPath{}; // Empty: a fresh file in the temp directory
+    };
+
+    struct Stats
+    {
+        size_t hot = 0;
+        size_t warm = 0;
+        size_t cold = 0;
+        size_t warmBytes = 0;
+        uint64_t coldBytes = 0;
+    };
+public:
+    TieredHistoryStore(Editor& editor) :TieredHistoryStore{ editor, Options{} } {};
+    TieredHistoryStore(Editor& editor, Options options)
+        :editor{ editor }, options{ options }, spill{ options.spillPath }
+    {
+        this->options.hotEntries = std::max<size_t>(this->options.hotEntries, 1); // The oldest one is encoded against the next
+        this->compressor = std::jthread{ [this](std::stop_token stop) { this->compressLoop(stop); } };
+    }
+    ~TieredHistoryStore()
+    {
+        this->compressor.request_stop(); // Wakes the compressor through its stop_token wait, so the join cannot miss it
+    }
+public:
+    void push(Editor::Memento memo)
+    {
+        std::unique_lock lock{ this->mutex };
+        this->hot.emplace_back(HotEntry{ .sequence = this->nextSequence++, .memo = std::move(memo) });
+        if (this->hot.size() > this->options.hotEntries) this->workCV.notify_one();
+        // Back-pressure: when the compressor falls behind, the editing thread helps, so RAM stays bounded.
+        while (this->hot.size() > 4 * this->options.hotEntries) this->demoteOldest(lock);
+    }
+
+    // The newest memento. Compressed and spilled ones are faulted back in, relative to the editor's current state,
+    // which is exactly the state the next newer memento restored.
+    std::optional<Editor::Memento> pop()
+    {
+        std::unique_lock lock{ this->mutex };
+        if (!this->hot.empty())
+        {
+            auto memo = std::move(this->hot.back().memo);
+            this->hot.pop_back();
+            return memo;
+        }
+        std::string compressed{};
+        if (!this->warm.empty())
+        {
+            compressed = std::move(this->warm.back());
+            this->warmBytes -= compressed.size();
+            this->warm.pop_back();
+        }
+        else if (!this->cold.empty())
+        {
+            const auto [offset, length] = this->cold.back();
+            compressed = this->spill.read(offset, length);
+            this->cold.pop_back();
+            this->spill.truncate(offset);
+        }
+        else return std::nullopt;
+        lock.unlock();
+        return Editor::decodeSnapshot(HistoryCodec::decompress(compressed), this->editor.saveSnapshot());
+    }
+
+    bool empty() const
+    {
+        std::scoped_lock lock{ this->mutex };
+        return this->hot.empty() && this->warm.empty() && this->cold.empty();
+    }
+
+    Stats getStats() const
+    {
+        std::scoped_lock lock{ this->mutex };
+        return Stats{ .hot = this->hot.size(), .warm = this->warm.size(), .cold = this->cold.size(),
+            .warmBytes = this->warmBytes, .coldBytes = this->spill.getSize() };
+    }
+private:
+    struct HotEntry
+    {
+        uint64_t sequence = 0;
+        Editor::Memento memo;
+    };
+
+    void compressLoop(std::stop_token stop)
+    {
+        std::unique_lock lock{ this->mutex };
+        while (!stop.stop_requested())
+        {
+            if (this->hot.size() > this->options.hotEntries) this->demoteOldest(lock);
+            else this->workCV.wait(lock, stop, [&] { return this->hot.size() > this->options.hotEntries; });
+        }
+    }
+
+    void demoteOldest(std::unique_lock<std::mutex>& lock) // Hot -> warm, and warm -> cold beyond the budget
+    {
+        // Mementos are immutable, so copies can be encoded without holding the lock.
+        const HotEntry oldest = this->hot[0];
+        const HotEntry base = this->hot[1];
+        lock.unlock();
+        std::string compressed = HistoryCodec::compress(Editor::encodeSnapshot(oldest.memo, base.memo));
+        lock.lock();
+
+        if (this->hot.size() < 2 || this->hot[0].sequence != oldest.sequence || this->hot[1].sequence != base.sequence)
+            return; // Undo or the other thread took them meanwhile
+        this->warmBytes += compressed.size();
+        this->warm.emplace_back(std::move(compressed));
+        this->hot.pop_front();
+
+        while (this->warmBytes > this->options.memoryBudget && !this->warm.empty())
+        {
+            const auto& record = this->warm.front();
+            const auto offset = this->spill.append(record);
+            if (!offset) break; // Disk trouble: stay over the budget rather than lose history
+            this->cold.emplace_back(*offset, record.size());
+            this->warmBytes -= record.size();
+            this->warm.pop_front();
+        }
+    }
+private:
+    Editor& editor;
+    Options options;
+    mutable std::mutex mutex;
+    std::condition_variable_any workCV;
+    std::deque<HotEntry> hot; // Oldest first in every tier
+    std::deque<std::string> warm; // Each one encoded against the next newer memento
+    std::vector<std::pair<uint64_t, size_t>> cold; // Offset and length in the spill file
+    size_t warmBytes = 0;
+    uint64_t nextSequence = 0;
+    SpillFile spill;
+    std::jthread compressor;
+};
+
+class TieredEditorUser // EditorUser whose histories live in a TieredHistoryStore
+{
+public:
+    TieredEditorUser() = delete;
+    TieredEditorUser(Editor& editor, TieredHistoryStore::Options options = {})
+        :editor{ editor }, histories{ editor, options } {};
+public:
+    const Editor::State& getState() const { return this->editor.state; }
+    void setText(std::string_view text)
+    {
+        saveMemento();
+        this->editor.state.text = text;
+    }
+    void setFont(std::string_view font)
+    {
+        saveMemento();
+        this->editor.state.font = font;
+    }
+    void replaceText(size_t offset, size_t count, std::string_view text)
+    {
+        saveMemento();
+        this->editor.state.text.replace(offset, count, text);
+    }
+    void undo()
+    {
+        auto memo = this->histories.pop();
+        if (!memo)
+        {
+            std::cerr << "No histories!\n";
+            return;
+        }
+        this->editor.restoreFromSnapshot(*memo);
+    }
+    TieredHistoryStore::Stats getStats() const { return this->histories.getStats(); }
+protected:
+    void saveMemento()
+    {
+        this->histories.push(this->editor.saveSnapshot());
+    }
+protected:
+    Editor& editor;
+    TieredHistoryStore histories;
+};
+
+class UndoTree // Undo keeps branches, and any point in time or depth is one O(log n) lookup away
+{
+public:
+    using Clock = std::chrono::system_clock;
+    using NodeID = uint32_t;
+public:
+    UndoTree(Editor::Memento initial)
+    {
+        this->nodes.emplace_back(Node{ .memo = std::move(initial), .parent = 0, .jump = 0, .depth = 0 });
+        this->visit(0, this->nodes[0].memo.getRecordTime(), true);
+    }
+public:
+    Editor::Memento& commit(Editor::Memento memo) // A new child of the current state, older branches stay reachable
+    {
+        const NodeID parent = this->current;
+        const NodeID jump = this->nextJump(parent);
+        const auto time = memo.getRecordTime();
+        this->nodes.emplace_back(Node{ .memo = std::move(memo), .parent = parent, .jump = jump, .depth = this->nodes[parent].depth + 1, .up = parent });
+        const auto node = static_cast<NodeID>(this->nodes.size() - 1);
+        this->access(node);
+        this->visit(node, time, true);
+        return this->nodes[node].memo;
+    }
+
+    Editor::Memento& undo(size_t steps = 1) // Walks `steps` ancestors up through jump pointers
+    {
+        const uint32_t depth = this->nodes[this->current].depth;
+        return this->moveTo(this->ancestorAt(this->current, depth - static_cast<uint32_t>(std::min<size_t>(steps, depth))));
+    }
+
+    Editor::Memento& redo() // Follows the branch that was committed or visited last
+    {
+        const NodeID child = this->preferredChild(this->current);
+        return this->moveTo(child == NoNode ? this->current : child);
+    }
+
+    Editor::Memento* restoreAsOf(Clock::time_point time) // The state that was current at `time`; nullptr before getHorizon()
+    {
+        if (time < this->horizon) return nullptr;
+        auto visited = std::upper_bound(this->timeline.begin(), this->timeline.end(), time,
+            [](Clock::time_point time, const Visit& visit) { return time < visit.time; });
+        return &this->moveTo(visited == this->timeline.begin() ? 0 : std::prev(visited)->node);
+    }
+
+    size_t size() const { return this->nodes.size(); }
+    uint32_t getDepth() const { return this->nodes[this->current].depth; }
+    Clock::time_point getHorizon() const { return this->horizon; } // restoreAsOf() is exact from here on, older navigations were dropped
+private:
+    static constexpr NodeID NoNode = UINT32_MAX;
+    static constexpr size_t MaxNavigations = 1 << 20; // Undo/redo/restore visits kept in the timeline, commits are always kept
+
+    struct Node
+    {
+        Editor::Memento memo;
+        NodeID parent;
+        NodeID jump; // Skew-binary jump pointer, gives O(log n) level-ancestor queries with O(1) space
+        uint32_t depth;
+        NodeID left = NoNode; // Splay tree over the node's preferred path, ordered by depth
+        NodeID right = NoNode;
+        NodeID up = NoNode; // Splay parent, or for a splay root the node its path hangs from
+    };
+
+    struct Visit
+    {
+        Clock::time_point time;
+        NodeID node;
+        bool committed;
+    };
+
+    NodeID nextJump(NodeID parent) const
+    {
+        const Node& p = this->nodes[parent];
+        const Node& j = this->nodes[p.jump];
+        if (p.depth - j.depth == j.depth - this->nodes[j.jump].depth && p.jump != j.jump) return j.jump;
+        return parent;
+    }
+
+    NodeID ancestorAt(NodeID node, uint32_t depth) const
+    {
+        while (this->nodes[node].depth > depth)
+            node = this->nodes[this->nodes[node].jump].depth >= depth ? this->nodes[node].jump : this->nodes[node].parent;
+        return node;
+    }
+
+    // Redo links are the preferred paths of a link-cut tree: every node prefers the child toward the most recently visited
+    // node below it. A visit re-prefers the path from the root in amortized O(log n), however far apart the branches are.
+    bool isSplayRoot(NodeID node) const
+    {
+        const NodeID up = this->nodes[node].up;
+        return up == NoNode || (this->nodes[up].left != node && this->nodes[up].right != node);
+    }
+
+    void rotate(NodeID node)
+    {
+        Node& n = this->nodes[node];
+        const NodeID parent = n.up;
+        Node& p = this->nodes[parent];
+        if (!this->isSplayRoot(parent)) (this->nodes[p.up].left == parent ? this->nodes[p.up].left : this->nodes[p.up].right) = node;
+        n.up = p.up;
+        const bool fromLeft = p.left == node;
+        NodeID& inner = fromLeft ? n.right : n.left;
+        (fromLeft ? p.left : p.right) = inner;
+        if (inner != NoNode) this->nodes[inner].up = parent;
+        inner = parent;
+        p.up = node;
+    }
+
+    void splay(NodeID node)
+    {
+        while (!this->isSplayRoot(node))
+        {
+            const NodeID parent = this->nodes[node].up;
+            if (!this->isSplayRoot(parent))
+            {
+                const NodeID grandparent = this->nodes[parent].up;
+                this->rotate((this->nodes[parent].left == node) == (this->nodes[grandparent].left == parent) ? parent : node);
+            }
+            this->rotate(node);
+        }
+    }
+
+    void access(NodeID node) // Prefers the path from the root to node; node keeps its own preferred child, redo goes on there
+    {
+        this->splay(node);
+        for (NodeID below = node, above = this->nodes[node].up; above != NoNode; below = above, above = this->nodes[above].up)
+        {
+            this->splay(above);
+            this->nodes[above].right = below; // The branch preferred so far hangs off as a path of its own
+        }
+        this->splay(node);
+    }
+
+    NodeID preferredChild(NodeID node) // The next deeper node on node's preferred path
+    {
+        this->splay(node);
+        NodeID child = this->nodes[node].right;
+        if (child == NoNode) return NoNode;
+        while (this->nodes[child].left != NoNode) child = this->nodes[child].left;
+        this->splay(child); // Pays for the walk down
+        return child;
+    }
+
+    Editor::Memento& moveTo(NodeID node)
+    {
+        if (node != this->current)
+        {
+            this->access(node);
+            this->visit(node, Clock::now(), false);
+        }
+        return this->nodes[node].memo;
+    }
+
+    void visit(NodeID node, Clock::time_point time, bool committed)
+    {
+        if (!this->timeline.empty()) time = std::max(time, this->timeline.back().time); // Keeps the index sorted
+        this->timeline.emplace_back(Visit{ .time = time, .node = node, .committed = committed });
+        this->current = node;
+        if (!committed && ++this->navigations > MaxNavigations) this->compact();
+    }
+
+    void compact() // Drops the older half of the navigations and moves the horizon past them
+    {
+        size_t dropped = this->navigations / 2;
+        this->navigations -= dropped;
+        bool gap = false;
+        auto kept = this->timeline.begin();
+        for (const Visit& visit : this->timeline)
+        {
+            if (!visit.committed && dropped > 0)
+            {
+                --dropped;
+                gap = true;
+                continue;
+            }
+            if (gap) this->horizon = visit.time; // Before it, a dropped navigation may have been current
+            gap = false;
+            *kept++ = visit;
+        }
+        this->timeline.erase(kept, this->timeline.end());
+    }
+private:
+    std::vector<Node> nodes;
+    std::vector<Visit> timeline; // Every commit and the recent navigations, in time order
+    size_t navigations = 0;
+    Clock::time_point horizon = Clock::time_point::min();
+    NodeID current = 0;
+};
+
+class TimeTravelEditorUser // EditorUser on top of an UndoTree
+{
+public:
+    TimeTravelEditorUser() = delete;
+    TimeTravelEditorUser(Editor& editor) :editor{ editor }, histories{ editor.saveSnapshot() } {};
+public:
+    const Editor::State& getState() const { return this->editor.state; }
+    void setText(std::string_view text)
+    {
+        this->editor.state.text = text;
+        saveMemento();
+    }
+    void setFont(std::string_view font)
+    {
+        this->editor.state.font = font;
+        saveMemento();
+    }
+    void replaceText(size_t offset, size_t count, std::string_view text)
+    {
+        this->editor.state.text.replace(offset, count, text);
+        saveMemento();
+    }
+    void undo(size_t steps = 1) { this->editor.restoreFromSnapshot(this->histories.undo(steps)); }
+    void redo() { this->editor.restoreFromSnapshot(this->histories.redo()); }
+    bool restoreAsOf(std::chrono::system_clock::time_point time) // False for times before the history's horizon
+    {
+        Editor::Memento* memo = this->histories.restoreAsOf(time);
+        if (memo) this->editor.restoreFromSnapshot(*memo);
+        return memo != nullptr;
+    }
+    const UndoTree& getHistories() const { return this->histories; }
+protected:
+    void saveMemento() // Snapshots are taken after each edit, the tree's root holds the initial state
+    {
+        this->histories.commit(this->editor.saveSnapshot());
+    }
+protected:
+    Editor& editor;
+    UndoTree histories;
+};
+
+void benchmarkUndoTree() // 10^6 history entries with branches
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t edits = 1'000'000;
+    constexpr size_t queries = 100'000;
+    auto nanoseconds = [](Clock::duration duration) { return std::chrono::duration<double, std::nano>(duration).count(); };
+
+    std::mt19937_64 random{ 11 };
+    Editor editor{};
+    TimeTravelEditorUser user{ editor };
+    user.setText(std::string(64 << 10, '.'));
+    std::vector<std::chrono::system_clock::time_point> times{};
+    auto begin = Clock::now();
+    for (size_t i = 0; i < edits; ++i)
+    {
+        user.replaceText(random() % (64 << 10), 4, "edit");
+        if (random() % 10 == 0) user.undo(1 + random() % 8); // Abandoned branches are kept
+        if (i % 1000 == 0) times.emplace_back(std::chrono::system_clock::now());
+    }
+    std::cout << std::format("[Undo tree] {} nodes, depth {}, {:.0f} ns/edit\n",
+        user.getHistories().size(), user.getHistories().getDepth(), nanoseconds(Clock::now() - begin) / edits);
+
+    begin = Clock::now();
+    for (size_t i = 0; i < queries; ++i)
+    {
+        user.undo(random() % user.getHistories().getDepth());
+        user.redo();
+    }
+    std::cout << std::format("[Undo tree] jump N steps: {:.0f} ns\n", nanoseconds(Clock::now() - begin) / (2 * queries));
+
+    size_t restored = 0;
+    begin = Clock::now();
+    for (size_t i = 0; i < queries; ++i)
+        restored += user.restoreAsOf(times[random() % times.size()]);
+    std::cout << std::format("[Undo tree] restore as of time T: {:.0f} ns, {} of {} within the horizon\n",
+        nanoseconds(Clock::now() - begin) / queries, restored, queries);
+
+    Editor stackEditor{}; // Baseline: one pop per step
+    EditorUser stackUser{ stackEditor };
+    stackUser.setText(std::string(64 << 10, '.'));
+    for (size_t i = 0; i < edits; ++i)
+        stackUser.replaceText(random() % (64 << 10), 4, "edit");
+    begin = Clock::now();
+    for (size_t i = 0; i < edits / 2; ++i)
+        stackUser.undo();
+    std::cout << std::format("[Stack    ] undo {} steps sequentially: {:.0f} ns\n", edits / 2, nanoseconds(Clock::now() - begin));
+}
+
+void benchmarkTieredSession() // A long session stays within budget, then undoes all the way back
+{
+    constexpr size_t documentSize = 1 << 20;
+    constexpr size_t edits = 200'000;
+    std::mt19937_64 random{ 7 };
+    std::string document(documentSize, ' ');
+    for (auto& c : document) c = static_cast<char>('a' + random() % 26);
+
+    Editor editor{};
+    TieredEditorUser user{ editor, TieredHistoryStore::Options{ .hotEntries = 256, .memoryBudget = 4 << 20 } };
+    user.setText(document);
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < edits; ++i)
+        user.replaceText(random() % documentSize, 8, std::format("edit{:04}", i % 10000));
+    const double editSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::this_thread::sleep_for(200ms); // Let the compressor catch up
+    auto stats = user.getStats();
+    std::cout << std::format("[Tiered] {:.2f} us/edit | hot {} | warm {} ({:.1f} MB) | cold {} ({:.1f} MB) | live rope {:.1f} MB\n",
+        editSeconds * 1e6 / edits, stats.hot, stats.warm, stats.warmBytes / double(1 << 20), stats.cold, stats.coldBytes / double(1 << 20),
+        PersistentText::liveBytes() / double(1 << 20));
+
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < edits; ++i)
+        user.undo();
+    const double undoSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << std::format("[Tiered] {:.2f} us/undo, restored the original: {}\n",
+        undoSeconds * 1e6 / edits, user.getState().text.str() == document ? "yes" : "NO");
+}
+
+void benchmarkHistories() // 100k small edits on a 10 MB document
+{
+    constexpr size_t documentSize = 10 << 20;
+    constexpr size_t edits = 100'000;
+    constexpr size_t editSize = 16;
+    constexpr size_t copySamples = 200; // Full copies are only sampled, 100k of them would need ~1 TB
+    using Clock = std::chrono::steady_clock;
+    auto microseconds = [](Clock::duration duration) { return std::chrono::duration<double, std::micro>(duration).count(); };
+
+    std::mt19937_64 random{ 42 };
+    std::string document(documentSize, ' ');
+    for (auto& c : document) c = static_cast<char>('a' + random() % 26);
+    std::string patch(editSize, 'x');
+
+    // Deep-copy mementos, as a State of plain std::strings would need
+    std::string copyText = document;
+    std::stack<std::string> copyHistory{};
+    auto begin = Clock::now();
+    for (size_t i = 0; i < copySamples; ++i)
+    {
+        copyHistory.push(copyText);
+        copyText.replace(random() % (documentSize - editSize), editSize, patch);
+    }
+    const double copyEdit = microseconds(Clock::now() - begin) / copySamples;
+    begin = Clock::now();
+    for (size_t i = 0; i < copySamples; ++i)
+    {
+        copyText = copyHistory.top();
+        copyHistory.pop();
+    }
+    const double copyUndo = microseconds(Clock::now() - begin) / copySamples;
+    std::cout << std::format("[Full copies   ] {:.1f} us/edit, {:.1f} us/undo, {:.1f} GB history for {} edits (extrapolated)\n",
+        copyEdit, copyUndo, static_cast<double>(documentSize) * edits / (1ull << 30), edits);
+
+    // Snapshots of the persistent State: O(1) to take, chunks shared between all of them
+    {
+        Editor persistentEditor{};
+        EditorUser persistentUser{ persistentEditor };
+        persistentUser.setText(document);
+        const size_t baseBytes = PersistentText::liveBytes();
+        begin = Clock::now();
+        for (size_t i = 0; i < edits; ++i)
+        {
+            for (auto& c : patch) c = static_cast<char>('A' + random() % 26);
+            persistentUser.replaceText(random() % (documentSize - editSize), editSize, patch);
+        }
+        const double persistentEdit = microseconds(Clock::now() - begin) / edits;
+        const size_t historyBytes = PersistentText::liveBytes() - baseBytes;
+        begin = Clock::now();
+        for (size_t i = 0; i < 1000; ++i)
+            persistentUser.undo();
+        const double persistentUndo = microseconds(Clock::now() - begin) / 1000;
+        std::cout << std::format("[Persistent    ] {:.2f} us/edit, {:.2f} us/undo, {:.1f} MB history\n",
+            persistentEdit, persistentUndo, historyBytes / double(1 << 20));
+    }
+
+    for (size_t interval : { 1000, 10000 })
+    {
+        Editor deltaEditor{};
+        DeltaEditorUser deltaUser{ deltaEditor, interval };
+        deltaUser.replaceText(0, 0, document);
+        begin = Clock::now();
+        for (size_t i = 0; i < edits; ++i)
+        {
+            for (auto& c : patch) c = static_cast<char>('A' + random() % 26);
+            deltaUser.replaceText(random() % (documentSize - editSize), editSize, patch);
+        }
+        const double deltaEdit = microseconds(Clock::now() - begin) / edits;
+        const size_t memory = deltaUser.getMemory();
+
+        begin = Clock::now();
+        for (size_t i = 0; i < 1000; ++i)
+            deltaUser.undo();
+        const double deltaUndo = microseconds(Clock::now() - begin) / 1000;
+        begin = Clock::now();
+        deltaUser.undo(interval / 2 + 1234); // Jump far back through a checkpoint
+        const double deltaJump = microseconds(Clock::now() - begin);
+        std::cout << std::format("[Delta, every {:>5}] {:.2f} us/edit, {:.2f} us/undo, {:.0f} us multi-step undo, {:.1f} MB history\n",
+            interval, deltaEdit, deltaUndo, deltaJump, memory / double(1 << 20));
+    }
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkHistories();
+        benchmarkTieredSession();
+        benchmarkUndoTree();
+        return EXIT_SUCCESS;
+    }
+
     Editor myTextEditor{};
     EditorUser user{ myTextEditor };
 
@@ -109,6 +1311,40 @@ int main(int argc, char* argv[])
     user.setText("Hello World");
     std::cout << user.getState();
 
+    Editor myDeltaEditor{};
+    DeltaEditorUser deltaUser{ myDeltaEditor, 2 };
+    deltaUser.setFont("Arial");
+    deltaUser.setText("Hello Word");
+    deltaUser.setText("Hello World"); // Records only the inserted "l"
+    deltaUser.setText("Hello World!");
+    deltaUser.undo();
+    std::cout << deltaUser.getState();
+    deltaUser.undo(2);
+    std::cout << deltaUser.getState();
+
+    Editor myTieredEditor{};
+    TieredEditorUser tieredUser{ myTieredEditor, TieredHistoryStore::Options{ .hotEntries = 1, .memoryBudget = 0 } };
+    tieredUser.setFont("Arial");
+    tieredUser.setText("Hello Word");
+    tieredUser.setText("Hello World");
+    std::this_thread::sleep_for(50ms); // Older histories get compressed and spilled meanwhile
+    tieredUser.undo();
+    tieredUser.undo(); // Faulted back in from disk
+    std::cout << tieredUser.getState();
+
+    Editor myTimeTravelEditor{};
+    TimeTravelEditorUser timeTravelUser{ myTimeTravelEditor };
+    timeTravelUser.setText("Hello Word");
+    const auto beforeFix = std::chrono::system_clock::now();
+    std::this_thread::sleep_for(10ms);
+    timeTravelUser.setText("Hello World");
+    timeTravelUser.undo();
+    timeTravelUser.setText("Hello, World"); // A new branch, "Hello World" is kept
+    if (!timeTravelUser.restoreAsOf(beforeFix)) std::cerr << "That part of the history was compacted away!\n";
+    std::cout << timeTravelUser.getState();
+    timeTravelUser.redo();
+    std::cout << timeTravelUser.getState();
+
     return EXIT_SUCCESS;
 }
 
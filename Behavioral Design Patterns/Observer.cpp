@@ -10,31 +10,563 @@ that happen to the object they’re observing.
 #include <format>
 #include <vector>
 #include <memory>
+#include <span>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <bit>
+#include <random>
+#include <array>
+#include <functional>
+#include <cassert>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+using namespace std::chrono_literals;
 
 class Subscriber
 {
 public:
+    virtual ~Subscriber() = default;
+
     virtual void notify(std::string_view message)
     {
         std::cout << message;
     }
+
+    // Batched delivery used by AsyncPublisher (one call per burst of messages).
+    virtual void notifyBatch(std::span<const std::string> messages)
+    {
+        for (const auto& message : messages)
+            this->notify(message);
+    }
+};
+
+struct Subscription // Handle into the publisher's slot map, a reused slot makes old handles stale.
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
 };
 
 class Publisher
 {
 public:
-    void addSubscriber(std::shared_ptr<Subscriber> subscriber)
+    virtual ~Publisher() = default;
+
+    Subscription addSubscriber(std::shared_ptr<Subscriber> subscriber)
     {
+        uint32_t index = this->freeSlot;
+        if (index == UINT32_MAX)
+        {
+            index = static_cast<uint32_t>(this->slots.size());
+            this->slots.emplace_back();
+        }
+        else this->freeSlot = this->slots[index].dense;
+
+        auto& slot = this->slots[index];
+        slot.dense = static_cast<uint32_t>(this->subsribers.size());
         this->subsribers.emplace_back(subscriber);
+        this->denseToSlot.emplace_back(index);
+        return Subscription{ .index = index, .generation = slot.generation };
     }
 
+    // O(1): the last subscriber fills the hole. Do not call it from inside notify().
+    bool removeSubscriber(Subscription subscription)
+    {
+        if (!this->isSubscribed(subscription)) return false; // Stale or foreign handle
+
+        auto& slot = this->slots[subscription.index];
+        const uint32_t last = static_cast<uint32_t>(this->subsribers.size() - 1);
+        if (slot.dense != last)
+        {
+            this->subsribers[slot.dense] = std::move(this->subsribers[last]);
+            this->denseToSlot[slot.dense] = this->denseToSlot[last];
+            this->slots[this->denseToSlot[slot.dense]].dense = slot.dense;
+        }
+        this->subsribers.pop_back(); // Releases the subscriber, capacity is kept for reuse
+        this->denseToSlot.pop_back();
+
+        slot.generation += 1;
+        slot.dense = this->freeSlot;
+        this->freeSlot = subscription.index;
+        return true;
+    }
+
+    bool isSubscribed(Subscription subscription) const
+    {
+        return subscription.index < this->slots.size()
+            && this->slots[subscription.index].generation == subscription.generation;
+    }
+
+    size_t countSubscribers() const { return this->subsribers.size(); }
+
     virtual void notifySubscribers(std::string_view message)
     {
         for (const auto& subsriber : this->subsribers)
             subsriber->notify(message);
     }
 protected:
-    std::vector<std::shared_ptr<Subscriber>> subsribers;
+    struct Slot
+    {
+        uint32_t dense = 0; // Position in subsribers, or the next free slot once released
+        uint32_t generation = 1;
+    };
+protected:
+    std::vector<std::shared_ptr<Subscriber>> subsribers; // Dense, iterated on every notification
+    std::vector<uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    uint32_t freeSlot = UINT32_MAX;
+};
+
+enum class OverflowPolicy { DropOldest, Block, Disconnect };
+
+struct DeliveryStats
+{
+    uint64_t enqueued = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;
+    uint64_t lag = 0; // Accepted but not delivered yet
+    uint64_t maxLag = 0;
+    bool disconnected = false;
+};
+
+class AsyncPublisher // Every subscriber owns a bounded mailbox, so a slow one can only fall behind by itself.
+{
+public:
+    struct Options
+    {
+        size_t workers = 2;
+        size_t queueCapacity = 1024; // Rounded up to a power of two
+        size_t batchSize = 64; // Upper bound of messages per notifyBatch()
+    };
+public:
+    AsyncPublisher() :AsyncPublisher{ Options{} } {};
+    AsyncPublisher(Options options) :options{ options }
+    {
+        for (size_t i = 0; i < std::max<size_t>(options.workers, 1); ++i)
+            this->workers.emplace_back([this] { this->work(); });
+    }
+    ~AsyncPublisher()
+    {
+        {
+            std::scoped_lock lock{ this->readyMutex };
+            this->stopping = true;
+        }
+        this->readyCV.notify_all();
+        this->workers.clear(); // Join after the remaining mailboxes are drained
+    }
+public:
+    // Publisher-side calls (add/removeSubscriber, notifySubscribers, flush, getStats) must come from one thread.
+    Subscription addSubscriber(std::shared_ptr<Subscriber> subscriber, OverflowPolicy policy = OverflowPolicy::DropOldest)
+    {
+        auto mailbox = std::make_shared<Mailbox>(*this, std::move(subscriber), policy, this->options.queueCapacity);
+        const Subscription subscription = this->mailboxes.addSubscriber(mailbox);
+        if (this->slotMailboxes.size() <= subscription.index) this->slotMailboxes.resize(subscription.index + 1);
+        this->slotMailboxes[subscription.index] = std::move(mailbox);
+        return subscription;
+    }
+
+    // Undelivered messages are dropped, a batch that a worker is delivering right now still completes.
+    bool removeSubscriber(Subscription subscription)
+    {
+        if (!this->mailboxes.removeSubscriber(subscription)) return false;
+        this->slotMailboxes[subscription.index]->close();
+        this->slotMailboxes[subscription.index].reset(); // Workers release it once it leaves the ready queue
+        return true;
+    }
+
+    bool isSubscribed(Subscription subscription) const { return this->mailboxes.isSubscribed(subscription); }
+
+    size_t countSubscribers() const { return this->mailboxes.countSubscribers(); }
+
+    void notifySubscribers(std::string_view message) { this->mailboxes.notifySubscribers(message); }
+
+    void flush() // Wait until every connected subscriber has caught up
+    {
+        for (auto& mailbox : this->slotMailboxes)
+            while (mailbox && mailbox->getStats().lag != 0)
+                std::this_thread::sleep_for(50us);
+    }
+
+    DeliveryStats getStats(Subscription subscription) const // Empty for a stale handle
+    {
+        return this->isSubscribed(subscription) ? this->slotMailboxes[subscription.index]->getStats() : DeliveryStats{};
+    }
+private:
+    class Mailbox // Bounded SPSC ring: the publisher produces, one worker at a time consumes.
+        :public Subscriber, public std::enable_shared_from_this<Mailbox>
+    {
+    public:
+        Mailbox(AsyncPublisher& owner, std::shared_ptr<Subscriber> subscriber, OverflowPolicy policy, size_t capacity)
+            :owner{ owner }, subscriber{ std::move(subscriber) }, policy{ policy }, ring(std::bit_ceil(std::max<size_t>(capacity, 2)))
+        {
+            this->mask = this->ring.size() - 1;
+        }
+
+        void notify(std::string_view message) override // Called by the owner's fan-out Publisher
+        {
+            if (this->push(message)) this->owner.schedule(*this);
+        }
+
+        void close() { this->closed.store(true, std::memory_order_release); }
+        bool isClosed() const { return this->closed.load(std::memory_order_acquire); }
+
+        bool push(std::string_view message)
+        {
+            if (this->disconnected.load(std::memory_order_relaxed))
+            {
+                this->rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            const uint64_t t = this->tail.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const uint64_t r = this->released.load(std::memory_order_acquire);
+                if (t - r < this->ring.size()) break;
+                switch (this->policy)
+                {
+                case OverflowPolicy::Disconnect:
+                    this->disconnected.store(true, std::memory_order_relaxed);
+                    this->rejected.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::Block:
+                    this->released.wait(r, std::memory_order_acquire);
+                    break;
+                case OverflowPolicy::DropOldest:
+                {
+                    // Steal the oldest slot back, unless the consumer is moving it out right now.
+                    uint64_t h = r;
+                    if (this->head.compare_exchange_strong(h, h + 1, std::memory_order_acq_rel))
+                    {
+                        this->release(h + 1);
+                        this->evicted.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else std::this_thread::yield();
+                    break;
+                }
+                }
+            }
+            this->ring[t & this->mask].assign(message); // Reuses the slot's capacity
+            this->tail.store(t + 1);
+
+            const uint64_t lag = t + 1 - this->delivered.load(std::memory_order_relaxed) - this->evicted.load(std::memory_order_relaxed);
+            if (lag > this->maxLag.load(std::memory_order_relaxed))
+                this->maxLag.store(lag, std::memory_order_relaxed);
+            return true;
+        }
+
+        void drain(size_t batchSize)
+        {
+            uint64_t h = this->head.load(std::memory_order_acquire);
+            uint64_t n = 0;
+            do
+            {
+                n = std::min<uint64_t>(this->tail.load(std::memory_order_acquire) - h, batchSize);
+                if (n == 0) return;
+            } while (!this->head.compare_exchange_weak(h, h + n, std::memory_order_acq_rel, std::memory_order_acquire));
+
+            // Swap the claimed slots out, so the ring is free again before the (maybe slow) subscriber runs.
+            if (this->batch.size() < n) this->batch.resize(n);
+            for (uint64_t i = 0; i < n; ++i)
+                this->batch[i].swap(this->ring[(h + i) & this->mask]);
+            this->release(h + n);
+
+            this->subscriber->notifyBatch(std::span<const std::string>{ this->batch.data(), static_cast<size_t>(n) });
+            this->delivered.fetch_add(n, std::memory_order_release);
+        }
+
+        bool hasPending() const { return this->head.load() != this->tail.load(); }
+
+        DeliveryStats getStats() const
+        {
+            DeliveryStats stats{};
+            stats.enqueued = this->tail.load(std::memory_order_acquire);
+            stats.delivered = this->delivered.load(std::memory_order_acquire);
+            const uint64_t evicted = this->evicted.load(std::memory_order_relaxed);
+            stats.dropped = evicted + this->rejected.load(std::memory_order_relaxed);
+            stats.lag = stats.enqueued - stats.delivered - evicted;
+            stats.maxLag = this->maxLag.load(std::memory_order_relaxed);
+            stats.disconnected = this->disconnected.load(std::memory_order_relaxed);
+            return stats;
+        }
+    public:
+        std::atomic_flag scheduled;
+    private:
+        void release(uint64_t position) // Both sides may free slots, so only ever move forward
+        {
+            uint64_t r = this->released.load(std::memory_order_relaxed);
+            while (r < position && !this->released.compare_exchange_weak(r, position, std::memory_order_acq_rel)) {}
+            this->released.notify_all();
+        }
+    private:
+        AsyncPublisher& owner;
+        std::shared_ptr<Subscriber> subscriber;
+        OverflowPolicy policy;
+        std::vector<std::string> ring;
+        std::vector<std::string> batch; // Consumer side only
+        uint64_t mask = 0;
+        alignas(64) std::atomic<uint64_t> head{ 0 }; // Next slot to be claimed by the consumer
+        alignas(64) std::atomic<uint64_t> released{ 0 }; // Slots before it may be overwritten
+        alignas(64) std::atomic<uint64_t> tail{ 0 }; // Next slot to be written by the producer
+        std::atomic<uint64_t> delivered{ 0 };
+        std::atomic<uint64_t> evicted{ 0 };
+        std::atomic<uint64_t> rejected{ 0 };
+        std::atomic<uint64_t> maxLag{ 0 };
+        std::atomic<bool> disconnected{ false };
+        std::atomic<bool> closed{ false }; // Unsubscribed, workers drop it instead of draining
+    };
+private:
+    void schedule(Mailbox& mailbox)
+    {
+        if (mailbox.scheduled.test_and_set()) return; // Already queued or being drained
+        {
+            std::scoped_lock lock{ this->readyMutex };
+            this->ready.push_back(mailbox.shared_from_this());
+        }
+        this->readyCV.notify_one();
+    }
+
+    void work()
+    {
+        for (;;)
+        {
+            std::shared_ptr<Mailbox> mailbox{};
+            {
+                std::unique_lock lock{ this->readyMutex };
+                this->readyCV.wait(lock, [this] { return this->stopping || !this->ready.empty(); });
+                if (this->ready.empty()) return;
+                mailbox = std::move(this->ready.front());
+                this->ready.pop_front();
+            }
+            if (mailbox->isClosed()) continue;
+            mailbox->drain(this->options.batchSize);
+            mailbox->scheduled.clear();
+            // Requeue instead of looping, so a slow subscriber holds one worker for one batch at most.
+            if (mailbox->hasPending() && !mailbox->isClosed()) this->schedule(*mailbox);
+        }
+    }
+private:
+    Options options;
+    Publisher mailboxes; // Fans out to the mailboxes and hands out the subscription handles
+    std::vector<std::shared_ptr<Mailbox>> slotMailboxes; // Indexed by Subscription::index
+    std::mutex readyMutex;
+    std::condition_variable readyCV;
+    std::deque<std::shared_ptr<Mailbox>> ready;
+    bool stopping = false;
+    std::vector<std::jthread> workers; // Declared last, so workers stop before the mailboxes go away
+};
+
+template <typename T>
+class BoundedQueue // Lock-free bounded MPMC queue (Dmitry Vyukov's sequence-numbered cells)
+{
+public:
+    BoundedQueue(size_t capacity)
+        :capacity{ std::bit_ceil(std::max<size_t>(capacity, 2)) }, cells{ std::make_unique<Cell[]>(this->capacity) }
+    {
+        for (size_t i = 0; i < this->capacity; ++i)
+            this->cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool tryPush(T& value)
+    {
+        size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &this->cells[position & (this->capacity - 1)];
+            const auto diff = static_cast<intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+            if (diff == 0 && this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            if (diff < 0) return false; // Full
+            if (diff > 0) position = this->enqueuePosition.load(std::memory_order_relaxed);
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &this->cells[position & (this->capacity - 1)];
+            const auto diff = static_cast<intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1);
+            if (diff == 0 && this->dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            if (diff < 0) return false; // Empty
+            if (diff > 0) position = this->dequeuePosition.load(std::memory_order_relaxed);
+        }
+        value = std::move(cell->data);
+        cell->sequence.store(position + this->capacity, std::memory_order_release);
+        return true;
+    }
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+private:
+    size_t capacity;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePosition{ 0 };
+};
+
+struct BusSubscription
+{
+    size_t shard = 0;
+    Subscription subscription;
+};
+
+class ShardedEventBus // Subscribers are partitioned across shards, each shard is a Publisher on its own pinned thread.
+{
+public:
+    struct Options
+    {
+        size_t shards = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        size_t queueCapacity = 4096; // Per shard, rounded up to a power of two
+        bool pinThreads = true;
+    };
+public:
+    ShardedEventBus() :ShardedEventBus{ Options{} } {};
+    ShardedEventBus(Options options) :options{ options }
+    {
+        for (size_t i = 0; i < std::max<size_t>(options.shards, 1); ++i)
+            this->shards.emplace_back(std::make_unique<Shard>(options.queueCapacity));
+    }
+    ~ShardedEventBus() { this->stop(); }
+public:
+    // Subscriptions may only change while the bus is stopped, shards own their Publisher once running.
+    BusSubscription addSubscriber(std::shared_ptr<Subscriber> subscriber)
+    {
+        assert(!this->running && "Stop the bus before changing subscriptions!");
+        auto least = std::min_element(this->shards.begin(), this->shards.end(),
+            [](auto& a, auto& b) { return a->publisher.countSubscribers() < b->publisher.countSubscribers(); });
+        return BusSubscription{ .shard = static_cast<size_t>(least - this->shards.begin()), .subscription = (*least)->publisher.addSubscriber(subscriber) };
+    }
+
+    bool removeSubscriber(BusSubscription subscription)
+    {
+        assert(!this->running && "Stop the bus before changing subscriptions!");
+        return subscription.shard < this->shards.size() && this->shards[subscription.shard]->publisher.removeSubscriber(subscription.subscription);
+    }
+
+    void start()
+    {
+        if (this->running) return;
+        this->running = true;
+        for (size_t i = 0; i < this->shards.size(); ++i)
+        {
+            auto& shard = *this->shards[i];
+            shard.stopping.store(false);
+            shard.thread = std::jthread{ [&shard] { shard.run(); } };
+            if (this->options.pinThreads) pinThread(shard.thread, i % std::max<size_t>(std::thread::hardware_concurrency(), 1));
+        }
+    }
+
+    void stop() // Delivers everything already published, then joins the shard threads
+    {
+        if (!this->running) return;
+        for (auto& shard : this->shards)
+            shard->stopping.store(true, std::memory_order_release);
+        for (auto& shard : this->shards)
+            shard->thread = std::jthread{};
+        this->running = false;
+    }
+
+    // Thread-safe. Every shard receives every message, in publishing order per producer thread.
+    void publish(std::string_view message)
+    {
+        this->broadcast(std::make_shared<const std::string>(message));
+    }
+
+    // Messages sharing a key are enqueued under the same stripe lock, so all shards see them in one order.
+    void publish(std::string_view key, std::string_view message)
+    {
+        auto envelope = std::make_shared<const std::string>(message);
+        std::scoped_lock lock{ this->keyLocks[std::hash<std::string_view>{}(key) % this->keyLocks.size()] };
+        this->broadcast(std::move(envelope));
+    }
+
+    void flush() const
+    {
+        for (auto& shard : this->shards)
+            while (shard->delivered.load(std::memory_order_acquire) != shard->accepted.load(std::memory_order_acquire))
+                std::this_thread::yield();
+    }
+
+    size_t countShards() const { return this->shards.size(); }
+private:
+    using Envelope = std::shared_ptr<const std::string>; // One allocation shared by every shard
+
+    struct Shard
+    {
+        Shard(size_t capacity) :queue{ capacity } {};
+
+        void run()
+        {
+            Envelope envelope{};
+            size_t idleRounds = 0;
+            for (;;)
+            {
+                if (this->queue.tryPop(envelope))
+                {
+                    this->publisher.notifySubscribers(*envelope);
+                    envelope.reset();
+                    this->delivered.fetch_add(1, std::memory_order_release);
+                    idleRounds = 0;
+                }
+                else if (this->stopping.load(std::memory_order_acquire)
+                    && this->delivered.load(std::memory_order_relaxed) == this->accepted.load(std::memory_order_acquire)) return;
+                else if (++idleRounds < 1024) std::this_thread::yield();
+                else std::this_thread::sleep_for(20us);
+            }
+        }
+
+        Publisher publisher;
+        BoundedQueue<Envelope> queue;
+        alignas(64) std::atomic<uint64_t> accepted{ 0 };
+        alignas(64) std::atomic<uint64_t> delivered{ 0 };
+        std::atomic<bool> stopping{ false };
+        std::jthread thread;
+    };
+private:
+    void broadcast(Envelope envelope)
+    {
+        for (auto& shard : this->shards)
+        {
+            Envelope copy = envelope;
+            while (!shard->queue.tryPush(copy)) std::this_thread::yield(); // Back-pressure from a full shard
+            shard->accepted.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    static void pinThread(std::jthread& thread, size_t core)
+    {
+#if defined(_WIN32)
+        ::SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(core % CPU_SETSIZE, &cpuSet);
+        ::pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#endif // Other platforms simply run unpinned
+    }
+private:
+    Options options;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::array<std::mutex, 64> keyLocks;
+    bool running = false;
 };
 
 class FacebookUser
@@ -57,14 +589,136 @@ public:
     }
 };
 
+class CountingUser
+    :public Subscriber
+{
+public:
+    CountingUser(std::chrono::microseconds delay = 0us) :delay{ delay } {};
+
+    void notify(std::string_view /*message*/) override { this->count += 1; }
+    void notifyBatch(std::span<const std::string> messages) override
+    {
+        std::this_thread::sleep_for(this->delay); // Simulates a slow consumer (per batch)
+        this->count += messages.size();
+    }
+
+    std::atomic<size_t> count = 0;
+protected:
+    std::chrono::microseconds delay;
+};
+
+void benchmarkChurn() // Subscribe/unsubscribe millions of times while publishing
+{
+    constexpr size_t liveSubscribers = 1024;
+    constexpr size_t churnRounds = 4'000'000;
+    constexpr size_t publishEvery = 64;
+
+    Publisher publisher{};
+    auto subscriber = std::make_shared<CountingUser>();
+    std::vector<Subscription> handles{};
+    for (size_t i = 0; i < liveSubscribers; ++i)
+        handles.emplace_back(publisher.addSubscriber(subscriber));
+
+    std::mt19937 random{ 42 };
+    size_t staleDetected = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < churnRounds; ++round)
+    {
+        auto& handle = handles[random() % liveSubscribers];
+        const Subscription old = handle;
+        publisher.removeSubscriber(handle);
+        handle = publisher.addSubscriber(subscriber); // Reuses the slot just released
+        if (!publisher.removeSubscriber(old)) staleDetected += 1;
+        if (round % publishEvery == 0) publisher.notifySubscribers("tick");
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << std::format("[Churn] {} rounds in {:.3f}s ({:.1f} M subscribe+unsubscribe/s), {} stale handles rejected, {} notifications\n",
+        churnRounds, elapsed.count(), churnRounds / elapsed.count() / 1e6, staleDetected, subscriber->count.load());
+}
+
+class HashingUser // A subscriber with a little real work per message
+    :public Subscriber
+{
+public:
+    void notify(std::string_view message) override
+    {
+        for (char c : message)
+            this->digest = (this->digest ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+
+    uint64_t digest = 14695981039346656037ull;
+};
+
+void benchmarkShardScaling() // Fixed fan-out, spread over 1 to 32 shards
+{
+    constexpr size_t subscribers = 256;
+    constexpr size_t messages = 100'000;
+
+    for (size_t shards : { 1, 2, 4, 8, 16, 32 })
+    {
+        ShardedEventBus bus{ ShardedEventBus::Options{ .shards = shards, .queueCapacity = 8192 } };
+        for (size_t i = 0; i < subscribers; ++i)
+            bus.addSubscriber(std::make_shared<HashingUser>());
+        bus.start();
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i)
+            bus.publish("user-event: something happened on the timeline");
+        bus.flush();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::cout << std::format("[Shards = {:>2}] {:.3f}s, {:.1f} M deliveries/s\n",
+            shards, elapsed.count(), messages * subscribers / elapsed.count() / 1e6);
+    }
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkChurn();
+        benchmarkShardScaling();
+        return EXIT_SUCCESS;
+    }
+
     Publisher myApp{};
-    myApp.addSubscriber(std::make_shared<FacebookUser>());
+    auto facebook = myApp.addSubscriber(std::make_shared<FacebookUser>());
     myApp.addSubscriber(std::make_shared<TwitterUser>());
 
     myApp.notifySubscribers("Hello World\n");
 
+    myApp.removeSubscriber(facebook);
+    myApp.notifySubscribers("Bye Facebook\n");
+    if (!myApp.removeSubscriber(facebook)) std::cerr << "Stale subscription!\n";
+
+    AsyncPublisher myAsyncApp{ AsyncPublisher::Options{ .workers = 2, .queueCapacity = 256, .batchSize = 32 } };
+    auto fastUser = std::make_shared<CountingUser>();
+    auto slowUser = std::make_shared<CountingUser>(2ms);
+    auto fragileUser = std::make_shared<CountingUser>(2ms);
+    auto fast = myAsyncApp.addSubscriber(fastUser, OverflowPolicy::Block);
+    auto slow = myAsyncApp.addSubscriber(slowUser, OverflowPolicy::DropOldest);
+    auto fragile = myAsyncApp.addSubscriber(fragileUser, OverflowPolicy::Disconnect);
+
+    for (int i = 0; i < 100000; ++i)
+        myAsyncApp.notifySubscribers(std::format("Event {}", i));
+    myAsyncApp.flush();
+
+    for (auto [name, id] : { std::pair{ "Fast", fast }, std::pair{ "Slow", slow }, std::pair{ "Fragile", fragile } })
+    {
+        auto stats = myAsyncApp.getStats(id);
+        std::cout << std::format("{:<8} enqueued={} delivered={} dropped={} lag={} maxLag={} disconnected={}\n",
+            name, stats.enqueued, stats.delivered, stats.dropped, stats.lag, stats.maxLag, stats.disconnected);
+    }
+    myAsyncApp.removeSubscriber(fragile); // Its mailbox is released, the others keep their handles
+
+    ShardedEventBus bus{ ShardedEventBus::Options{ .shards = 2 } };
+    bus.addSubscriber(std::make_shared<FacebookUser>());
+    bus.addSubscriber(std::make_shared<TwitterUser>());
+    bus.start();
+    bus.publish("order-42", "Order 42 created");
+    bus.publish("order-42", "Order 42 shipped"); // Same key, same order on every shard
+    bus.stop();
+
     return EXIT_SUCCESS;
 }
-
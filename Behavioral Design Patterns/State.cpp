@@ -10,6 +10,17 @@ changed its class.
 #include <format>
 #include <vector>
 #include <memory>
+#include <array>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <span>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <deque>
+#include <limits>
 
 class Player
 {
@@ -93,13 +104,421 @@ protected:
     std::shared_ptr<State> state;
 };
 
+enum class PlayerState : uint8_t { Idle, Running, Flying, Count, Stay = Count };
+enum class PlayerEvent : uint8_t { BeginRun, EndRun, BeginFly, EndFly, Count };
+
+constexpr size_t PlayerStateCount = static_cast<size_t>(PlayerState::Count);
+constexpr size_t PlayerEventCount = static_cast<size_t>(PlayerEvent::Count);
+
+constexpr size_t transitionIndex(PlayerState state, PlayerEvent event)
+{
+    return static_cast<size_t>(state) * PlayerEventCount + static_cast<size_t>(event);
+}
+
+constexpr auto PlayerTransitions = [] // Built at compile time, flat so that dispatch is a single indexed load
+{
+    std::array<PlayerState, PlayerStateCount * PlayerEventCount> table{};
+    table.fill(PlayerState::Stay);
+    table[transitionIndex(PlayerState::Idle, PlayerEvent::BeginRun)] = PlayerState::Running;
+    table[transitionIndex(PlayerState::Idle, PlayerEvent::BeginFly)] = PlayerState::Flying;
+    table[transitionIndex(PlayerState::Flying, PlayerEvent::EndFly)] = PlayerState::Idle;
+    table[transitionIndex(PlayerState::Running, PlayerEvent::BeginRun)] = PlayerState::Running; // Re-enters, like Running::beginRun
+    table[transitionIndex(PlayerState::Running, PlayerEvent::EndRun)] = PlayerState::Idle;
+    table[transitionIndex(PlayerState::Running, PlayerEvent::BeginFly)] = PlayerState::Flying;
+    return table;
+}();
+static_assert(PlayerTransitions[transitionIndex(PlayerState::Flying, PlayerEvent::BeginRun)] == PlayerState::Stay);
+
+class TablePlayer // Same machine as Player: states are enum entries and one table lookup dispatches an event
+{
+public:
+    TablePlayer() { this->enter(PlayerState::Idle); }
+
+    void beginRun() { this->dispatch(PlayerEvent::BeginRun); }
+    void endRun() { this->dispatch(PlayerEvent::EndRun); }
+    void beginFly() { this->dispatch(PlayerEvent::BeginFly); }
+    void endFly() { this->dispatch(PlayerEvent::EndFly); }
+
+    void dispatch(PlayerEvent event)
+    {
+        const PlayerState next = PlayerTransitions[transitionIndex(this->state, event)];
+        if (next != PlayerState::Stay) this->enter(next);
+    }
+    PlayerState getState() const { return this->state; }
+public:
+    static constexpr std::array<std::string_view, PlayerStateCount> EntryMessages{ "Idling\n", "Running\n", "Flying\n" };
+protected:
+    void enter(PlayerState next)
+    {
+        this->state = next;
+        std::cout << EntryMessages[static_cast<size_t>(next)];
+    }
+protected:
+    PlayerState state = PlayerState::Idle;
+};
+
+class PlayerPopulation // Millions of TablePlayer machines kept as one byte of state per agent; entry messages are not printed
+{
+public:
+    explicit PlayerPopulation(size_t agents, size_t threads = std::thread::hardware_concurrency())
+        : states(agents, PlayerState::Idle), threads{ std::max<size_t>(threads, 1) } { }
+
+    void broadcast(PlayerEvent event) // Every agent receives the same event
+    {
+        const auto& column = Columns[static_cast<size_t>(event)];
+        PlayerState* states = this->states.data(); // Hoisted: byte stores would otherwise alias the vector's own pointer
+        this->forEachPartition([&column, states](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+                states[i] = select(column, states[i]);
+        });
+    }
+    void step(std::span<const PlayerEvent> events) // events[i] is delivered to agent i
+    {
+        if (events.size() != this->states.size())
+            throw std::invalid_argument{ "One event per agent is expected" };
+        PlayerState* states = this->states.data();
+        const PlayerEvent* delivered = events.data();
+        this->forEachPartition([states, delivered](size_t begin, size_t end)
+        {
+            for (size_t block = begin; block < end; block += BlockSize) // Blocks stay in L1 across the per-event passes
+                applyBlock(states + block, delivered + block, std::min(BlockSize, end - block));
+        });
+    }
+
+    PlayerState getState(size_t agent) const { return this->states[agent]; }
+    size_t countAgents() const { return this->states.size(); }
+    size_t countIn(PlayerState state) const { return std::ranges::count(this->states, state); }
+protected:
+    using Column = std::array<PlayerState, PlayerStateCount>;
+
+    static constexpr auto Columns = [] // PlayerTransitions regrouped by event, Stay resolved to the current state
+    {
+        std::array<Column, PlayerEventCount> columns{};
+        for (size_t e = 0; e < PlayerEventCount; e++)
+        {
+            for (size_t s = 0; s < PlayerStateCount; s++)
+            {
+                const PlayerState next = PlayerTransitions[transitionIndex(static_cast<PlayerState>(s), static_cast<PlayerEvent>(e))];
+                columns[e][s] = next == PlayerState::Stay ? static_cast<PlayerState>(s) : next;
+            }
+        }
+        return columns;
+    }();
+    static constexpr size_t BlockSize = 4096;
+
+    static uint8_t blend(uint8_t mask, uint8_t chosen, uint8_t other) { return (chosen & mask) | (other & ~mask); }
+
+    static PlayerState select(const Column& column, PlayerState state) // Compare-and-blend masks instead of a gather, so the loops vectorize
+    {
+        uint8_t next = static_cast<uint8_t>(column[0]);
+        for (size_t s = 1; s < PlayerStateCount; s++)
+        {
+            const uint8_t mask = -static_cast<uint8_t>(state == static_cast<PlayerState>(s));
+            next = blend(mask, static_cast<uint8_t>(column[s]), next);
+        }
+        return static_cast<PlayerState>(next);
+    }
+
+    static void applyBlock(PlayerState* states, const PlayerEvent* delivered, size_t count) // One pass per event type
+    {
+        for (size_t e = 0; e < PlayerEventCount; e++)
+        {
+            const auto event = static_cast<PlayerEvent>(e);
+            const auto& column = Columns[e];
+            for (size_t i = 0; i < count; i++)
+            {
+                const uint8_t mask = -static_cast<uint8_t>(delivered[i] == event);
+                states[i] = static_cast<PlayerState>(blend(mask, static_cast<uint8_t>(select(column, states[i])), static_cast<uint8_t>(states[i])));
+            }
+        }
+    }
+
+    template<typename Function>
+    void forEachPartition(Function&& function)
+    {
+        const size_t count = this->states.size();
+        const size_t partitions = std::min(this->threads, std::max<size_t>(count / BlockSize, 1));
+        const size_t stride = (count / partitions + 63) & ~size_t{ 63 }; // Partition edges on cache lines
+        std::vector<std::jthread> workers{};
+        for (size_t begin = stride; begin < count; begin += stride)
+            workers.emplace_back([&function, begin, stride, count] { function(begin, std::min(begin + stride, count)); });
+        function(0, std::min(stride, count));
+    }
+protected:
+    std::vector<PlayerState> states;
+    size_t threads;
+};
+
+enum class PlayerNode : uint8_t { Grounded, Idle, Running, Flying, Count, None = Count }; // Grounded nests Idle and Running
+constexpr size_t PlayerNodeCount = static_cast<size_t>(PlayerNode::Count);
+
+class QueuedPlayer // Player with queued run-to-completion events, nested states with entry and exit actions, and instrumentation
+{
+public:
+    using Action = std::function<void(QueuedPlayer&)>;
+    using Clock = std::chrono::steady_clock;
+
+    QueuedPlayer()
+    {
+        for (PlayerNode leaf : { PlayerNode::Idle, PlayerNode::Running, PlayerNode::Flying })
+            this->entryActions[node(leaf)] = [leaf](QueuedPlayer&) { std::cout << Names[node(leaf)] << "\n"; };
+        this->enterDown(PlayerNode::None, PlayerNode::Grounded, Clock::now());
+    }
+
+    void post(PlayerEvent event) { this->pending.push_back(event); } // Safe from inside actions: handled after the current event completes
+    void dispatch(PlayerEvent event)
+    {
+        this->post(event);
+        this->drain();
+    }
+    size_t drain(size_t limit = std::numeric_limits<size_t>::max()) // Handles queued events in FIFO batches, one at a time to completion
+    {
+        if (this->draining) return 0; // Called from an action: the outer drain picks the events up
+        this->draining = true;
+        size_t handled{ 0 };
+        while (handled < limit && !this->pending.empty())
+        {
+            const size_t batch = std::min(this->pending.size(), limit - handled);
+            for (size_t i = 0; i < batch; i++)
+                this->handle(this->pending[i]);
+            this->pending.erase(this->pending.begin(), this->pending.begin() + batch);
+            handled += batch;
+        }
+        this->draining = false;
+        return handled;
+    }
+
+    void setEntryAction(PlayerNode state, Action action) { this->entryActions[node(state)] = std::move(action); }
+    void setExitAction(PlayerNode state, Action action) { this->exitActions[node(state)] = std::move(action); }
+
+    PlayerNode getState() const { return this->leaf; }
+    bool isIn(PlayerNode state) const
+    {
+        for (PlayerNode n = this->leaf; n != PlayerNode::None; n = Parents[node(n)])
+            if (n == state) return true;
+        return false;
+    }
+    size_t countPending() const { return this->pending.size(); }
+
+    uint64_t getTransitionCount(PlayerNode from, PlayerNode to) const { return this->transitions[node(from) * PlayerNodeCount + node(to)]; }
+    uint64_t getUnhandledCount() const { return this->unhandled; }
+    Clock::duration getTimeIn(PlayerNode state) const // Includes the current stay when the state is active
+    {
+        Clock::duration time = this->timeIn[node(state)];
+        if (this->isIn(state)) time += Clock::now() - this->enteredAt[node(state)];
+        return time;
+    }
+    void report(std::ostream& output) const // Transitions between leaf states and time spent in every state
+    {
+        for (size_t from = 0; from < PlayerNodeCount; from++)
+            for (size_t to = 0; to < PlayerNodeCount; to++)
+                if (const uint64_t count = this->transitions[from * PlayerNodeCount + to])
+                    output << std::format("{:>8} -> {:<8} {:>10}\n", Names[from], Names[to], count);
+        for (size_t state = 0; state < PlayerNodeCount; state++)
+            output << std::format("{:>8} {:>14.3f} ms\n", Names[state],
+                std::chrono::duration<double, std::milli>(this->getTimeIn(static_cast<PlayerNode>(state))).count());
+    }
+public:
+    static constexpr std::array<std::string_view, PlayerNodeCount> Names{ "Grounded", "Idling", "Running", "Flying" };
+    static constexpr std::array<PlayerNode, PlayerNodeCount> Parents{ PlayerNode::None, PlayerNode::Grounded, PlayerNode::Grounded, PlayerNode::None };
+    static constexpr std::array<PlayerNode, PlayerNodeCount> Initial{ PlayerNode::Idle, PlayerNode::None, PlayerNode::None, PlayerNode::None };
+
+    static constexpr auto Handlers = [] // Target per (state, event), None lets the event bubble up to the parent state
+    {
+        std::array<PlayerNode, PlayerNodeCount * PlayerEventCount> table{};
+        table.fill(PlayerNode::None);
+        auto at = [](PlayerNode state, PlayerEvent event) { return static_cast<size_t>(state) * PlayerEventCount + static_cast<size_t>(event); };
+        table[at(PlayerNode::Grounded, PlayerEvent::BeginFly)] = PlayerNode::Flying; // Shared by Idle and Running
+        table[at(PlayerNode::Idle, PlayerEvent::BeginRun)] = PlayerNode::Running;
+        table[at(PlayerNode::Running, PlayerEvent::BeginRun)] = PlayerNode::Running;
+        table[at(PlayerNode::Running, PlayerEvent::EndRun)] = PlayerNode::Idle;
+        table[at(PlayerNode::Flying, PlayerEvent::EndFly)] = PlayerNode::Grounded; // Lands in Grounded's initial state
+        return table;
+    }();
+protected:
+    static constexpr size_t node(PlayerNode state) { return static_cast<size_t>(state); }
+
+    static bool contains(PlayerNode ancestor, PlayerNode state)
+    {
+        for (; state != PlayerNode::None; state = Parents[node(state)])
+            if (state == ancestor) return true;
+        return false;
+    }
+
+    void handle(PlayerEvent event)
+    {
+        PlayerNode handler = this->leaf;
+        PlayerNode target = PlayerNode::None;
+        for (; handler != PlayerNode::None; handler = Parents[node(handler)])
+            if ((target = Handlers[node(handler) * PlayerEventCount + static_cast<size_t>(event)]) != PlayerNode::None) break;
+        if (handler == PlayerNode::None)
+        {
+            this->unhandled++;
+            return;
+        }
+
+        PlayerNode domain = Parents[node(handler)]; // Innermost state strictly enclosing both ends, so self transitions exit and re-enter
+        while (domain != PlayerNode::None && (domain == target || !contains(domain, target)))
+            domain = Parents[node(domain)];
+
+        const PlayerNode source = this->leaf;
+        const auto now = Clock::now();
+        for (PlayerNode n = source; n != domain; n = Parents[node(n)])
+            this->exit(n, now);
+        this->enterDown(domain, target, now);
+        this->transitions[node(source) * PlayerNodeCount + node(this->leaf)]++;
+    }
+    void enterDown(PlayerNode domain, PlayerNode target, Clock::time_point now) // Enters target's ancestors below domain, target, then its initial states
+    {
+        std::array<PlayerNode, PlayerNodeCount> path{};
+        size_t depth{ 0 };
+        for (PlayerNode n = target; n != domain; n = Parents[node(n)])
+            path[depth++] = n;
+        while (depth > 0)
+            this->enter(path[--depth], now);
+        for (PlayerNode n = Initial[node(target)]; n != PlayerNode::None; n = Initial[node(n)])
+        {
+            this->enter(n, now);
+            target = n;
+        }
+        this->leaf = target;
+    }
+    void enter(PlayerNode state, Clock::time_point now)
+    {
+        this->enteredAt[node(state)] = now;
+        if (const auto& action = this->entryActions[node(state)]) action(*this);
+    }
+    void exit(PlayerNode state, Clock::time_point now)
+    {
+        this->timeIn[node(state)] += now - this->enteredAt[node(state)];
+        if (const auto& action = this->exitActions[node(state)]) action(*this);
+    }
+protected:
+    PlayerNode leaf = PlayerNode::None;
+    std::deque<PlayerEvent> pending;
+    bool draining = false;
+    std::array<Action, PlayerNodeCount> entryActions;
+    std::array<Action, PlayerNodeCount> exitActions;
+
+    std::array<uint64_t, PlayerNodeCount * PlayerNodeCount> transitions{}; // Instrumentation
+    std::array<Clock::time_point, PlayerNodeCount> enteredAt{};
+    std::array<Clock::duration, PlayerNodeCount> timeIn{};
+    uint64_t unhandled{ 0 };
+};
+
+void benchmarkPopulation()
+{
+    constexpr size_t agents = 10'000'000;
+    constexpr size_t steps = 16;
+    std::mt19937 random{ 1 };
+    std::array<std::vector<PlayerEvent>, 4> streams{};
+    for (auto& stream : streams)
+    {
+        stream.resize(agents);
+        for (auto& event : stream)
+            event = static_cast<PlayerEvent>(random() % PlayerEventCount);
+    }
+
+    for (size_t threads : { size_t{ 1 }, size_t{ std::max(std::thread::hardware_concurrency(), 1u) } })
+    {
+        PlayerPopulation population{ agents, threads };
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < steps; i++)
+            population.step(streams[i % streams.size()]);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << std::format("[Population x{:>2} threads] {:.0f} M agent-events/s, {} running, {} flying\n",
+            threads, agents * steps / seconds / 1e6, population.countIn(PlayerState::Running), population.countIn(PlayerState::Flying));
+    }
+}
+
+void benchmarkTablePlayer()
+{
+    constexpr size_t events = 10'000'000;
+    std::mt19937 random{ 1 };
+    std::vector<PlayerEvent> stream(events);
+    for (auto& event : stream)
+        event = static_cast<PlayerEvent>(random() % PlayerEventCount);
+
+    auto* output = std::cout.rdbuf(nullptr); // Entry messages of both machines are swallowed alike
+    auto begin = std::chrono::steady_clock::now();
+    Player player{};
+    for (PlayerEvent event : stream)
+    {
+        switch (event)
+        {
+        case PlayerEvent::BeginRun: player.beginRun(); break;
+        case PlayerEvent::EndRun: player.endRun(); break;
+        case PlayerEvent::BeginFly: player.beginFly(); break;
+        default: player.endFly(); break;
+        }
+    }
+    const double sharedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    TablePlayer tablePlayer{};
+    for (PlayerEvent event : stream)
+        tablePlayer.dispatch(event);
+    const double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout.rdbuf(output);
+    std::cout.clear();
+
+    std::cout << std::format("[shared_ptr states] {:.1f} M events/s\n", events / sharedSeconds / 1e6);
+    std::cout << std::format("[Transition table ] {:.1f} M events/s\n", events / tableSeconds / 1e6);
+
+    output = std::cout.rdbuf(nullptr);
+    begin = std::chrono::steady_clock::now();
+    QueuedPlayer queuedPlayer{};
+    constexpr size_t batch = 1024;
+    for (size_t i = 0; i < events; i += batch)
+    {
+        for (size_t j = i; j < std::min(i + batch, events); j++)
+            queuedPlayer.post(stream[j]);
+        queuedPlayer.drain();
+    }
+    const double queuedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout.rdbuf(output);
+    std::cout.clear();
+    std::cout << std::format("[Queued, nested   ] {:.1f} M events/s\n", events / queuedSeconds / 1e6);
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkTablePlayer();
+        benchmarkPopulation();
+        return EXIT_SUCCESS;
+    }
+
     Player player{};
     player.beginRun();
     player.beginFly();
     player.endRun();
     player.endFly();
+
+    TablePlayer tablePlayer{};
+    tablePlayer.beginRun();
+    tablePlayer.beginFly();
+    tablePlayer.endRun();
+    tablePlayer.endFly();
+
+    QueuedPlayer queuedPlayer{};
+    queuedPlayer.setEntryAction(PlayerNode::Flying, [](QueuedPlayer& host)
+    {
+        std::cout << "Flying\n";
+        host.post(PlayerEvent::EndFly); // Queued: runs after this transition completes
+    });
+    queuedPlayer.post(PlayerEvent::BeginRun);
+    queuedPlayer.post(PlayerEvent::BeginFly);
+    queuedPlayer.post(PlayerEvent::EndRun);
+    queuedPlayer.drain();
+    queuedPlayer.report(std::cout);
+
+    PlayerPopulation population{ 1000 };
+    population.broadcast(PlayerEvent::BeginRun);
+    population.broadcast(PlayerEvent::BeginFly);
+    std::cout << std::format("{} of {} agents flying\n", population.countIn(PlayerState::Flying), population.countAgents());
     
     return EXIT_SUCCESS;
 }
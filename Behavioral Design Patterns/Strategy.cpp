@@ -10,15 +10,42 @@ and make their objects interchangeable.
 #include <format>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <span>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <variant>
+#include <thread>
+#include <barrier>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 class Player;
 class PhysicalAttack;
 class MagicAttack;
+struct PlayerColumns;
+struct CombatDeltas;
+
+constexpr uint32_t saturatingSub(uint32_t value, uint32_t amount) { return value > amount ? value - amount : 0; }
+constexpr uint32_t saturatingAdd(uint32_t value, uint32_t amount)
+{
+    const uint32_t sum = value + amount;
+    return sum < value ? std::numeric_limits<uint32_t>::max() : sum;
+}
 
 class AttackStrategy
 {
 public:
     virtual bool operator()(Player& actor, Player& target) = 0;
+    virtual void accumulate(const PlayerColumns& players, std::span<const uint32_t> attackers, std::span<const uint32_t> targets,
+        CombatDeltas& deltas); // Batch form; the default replays operator() on each pair, built-in strategies override it with kernels
+    virtual bool partitionsByAttacker() const { return false; } // True when accumulate() reads no deltas but its attackers' own magic, so attackers may be split across threads
+public:
+    static inline std::ostream* log = &std::cout; // Where hits are reported, nullptr keeps the hot path quiet
 };
 
 class Player
@@ -43,38 +70,574 @@ protected:
     std::shared_ptr<AttackStrategy> attackStrategy;
 };
 
+struct PlayerColumns // Player::State of many players as struct of arrays, indexed by player id
+{
+    uint32_t add(const Player::State& state)
+    {
+        this->health.push_back(state.health);
+        this->magic.push_back(state.magic);
+        this->strength.push_back(state.strength);
+        this->intelligence.push_back(state.intelligence);
+        return static_cast<uint32_t>(this->health.size() - 1);
+    }
+    Player::State get(uint32_t player) const
+    {
+        return Player::State{ this->health[player], this->magic[player], this->strength[player], this->intelligence[player] };
+    }
+    size_t count() const { return this->health.size(); }
+
+    std::vector<uint32_t> health;
+    std::vector<uint32_t> magic;
+    std::vector<uint32_t> strength;
+    std::vector<uint32_t> intelligence;
+};
+
+struct CombatDeltas // What one tick takes away from each player, applied at the end of the tick
+{
+    void reset(size_t players)
+    {
+        this->damage.assign(players, 0);
+        this->magicSpent.assign(players, 0);
+    }
+
+    std::vector<uint32_t> damage;
+    std::vector<uint32_t> magicSpent;
+};
+
+void AttackStrategy::accumulate(const PlayerColumns& players, std::span<const uint32_t> attackers, std::span<const uint32_t> targets,
+    CombatDeltas& deltas)
+{
+    for (size_t i = 0; i < attackers.size(); i++)
+    {
+        const uint32_t a = attackers[i];
+        const uint32_t t = targets[i];
+        Player::State attackerState = players.get(a);
+        attackerState.health = saturatingSub(attackerState.health, deltas.damage[a]);
+        attackerState.magic = saturatingSub(attackerState.magic, deltas.magicSpent[a]);
+        Player::State targetState = players.get(t);
+        targetState.health = saturatingSub(targetState.health, deltas.damage[t]);
+        Player attacker{ attackerState, nullptr };
+        Player target{ targetState, nullptr };
+        (*this)(attacker, a == t ? attacker : target);
+
+        const Player::State& hit = a == t ? attacker.getState() : target.getState();
+        deltas.damage[t] = saturatingAdd(deltas.damage[t], saturatingSub(a == t ? attackerState.health : targetState.health, hit.health));
+        deltas.magicSpent[a] = saturatingAdd(deltas.magicSpent[a], saturatingSub(attackerState.magic, attacker.getState().magic));
+    }
+}
+
+void gatherSum(std::span<const uint32_t> indices, const uint32_t* first, const uint32_t* second, uint32_t* out) // out[i] = first[indices[i]] (+ second[indices[i]]), saturating
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= indices.size(); i += 8)
+    {
+        const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices.data() + i));
+        __m256i sum = _mm256_i32gather_epi32(reinterpret_cast<const int*>(first), index, 4);
+        if (second) // min(a, ~b) + b cannot wrap, and is a + b whenever that fits
+        {
+            const __m256i addend = _mm256_i32gather_epi32(reinterpret_cast<const int*>(second), index, 4);
+            sum = _mm256_add_epi32(_mm256_min_epu32(sum, _mm256_xor_si256(addend, _mm256_set1_epi32(-1))), addend);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sum);
+    }
+#endif
+    for (; i < indices.size(); i++)
+        out[i] = saturatingAdd(first[indices[i]], second ? second[indices[i]] : 0);
+}
+
+void subtractSaturating(std::span<uint32_t> values, std::span<const uint32_t> amounts) // values[i] = max(values[i] - amounts[i], 0)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= values.size(); i += 8)
+    {
+        const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values.data() + i));
+        const __m256i amount = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts.data() + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values.data() + i), _mm256_sub_epi32(_mm256_max_epu32(value, amount), amount));
+    }
+#endif
+    for (; i < values.size(); i++)
+        values[i] = saturatingSub(values[i], amounts[i]);
+}
+
 class PhysicalAttack
     :public AttackStrategy
 {
 public:
-    bool operator()(Player& attacker, Player& target) override
+    bool operator()(Player& attacker, Player& target) override { return apply(attacker.getState(), target.getState()); }
+    static bool apply(Player::State& sa, Player::State& st) // Non-virtual body shared with the closed-set dispatch
     {
-        auto& sa = attacker.getState();
-        auto& st = attacker.getState();
-        st.health -= sa.strength;
-        std::cout << std::format("Physical Attack Damage: {}\n", sa.strength);
+        st.health = saturatingSub(st.health, sa.strength);
+        if (log) *log << std::format("Physical Attack Damage: {}\n", sa.strength);
         return true;
     }
+    bool partitionsByAttacker() const override { return true; }
+    void accumulate(const PlayerColumns& players, std::span<const uint32_t> attackers, std::span<const uint32_t> targets,
+        CombatDeltas& deltas) override
+    {
+        std::array<uint32_t, 256> damage;
+        for (size_t begin = 0; begin < attackers.size(); begin += damage.size())
+        {
+            const size_t count = std::min(damage.size(), attackers.size() - begin);
+            gatherSum(attackers.subspan(begin, count), players.strength.data(), nullptr, damage.data());
+            for (size_t i = 0; i < count; i++) // Scattered: several attackers may share a target
+                deltas.damage[targets[begin + i]] = saturatingAdd(deltas.damage[targets[begin + i]], damage[i]);
+        }
+    }
 };
 
 class MagicAttack
     :public AttackStrategy
 {
 public:
-    bool operator()(Player& attacker, Player& target) override
+    bool operator()(Player& attacker, Player& target) override { return apply(attacker.getState(), target.getState()); }
+    static bool apply(Player::State& sa, Player::State& st)
     {
-        auto& sa = attacker.getState();
         if (sa.magic < 1) return false;
         else sa.magic -= 1;
-        auto& st = attacker.getState();
-        st.health -= sa.strength + sa.intelligence;
-        std::cout << std::format("Magic Attack Damage: {} (MP - {})\n", sa.strength + sa.intelligence, 1);
+        const uint32_t damage = saturatingAdd(sa.strength, sa.intelligence);
+        st.health = saturatingSub(st.health, damage);
+        if (log) *log << std::format("Magic Attack Damage: {} (MP - {})\n", damage, 1);
         return true;
     }
+    bool partitionsByAttacker() const override { return true; }
+    void accumulate(const PlayerColumns& players, std::span<const uint32_t> attackers, std::span<const uint32_t> targets,
+        CombatDeltas& deltas) override
+    {
+        std::array<uint32_t, 256> damage;
+        for (size_t begin = 0; begin < attackers.size(); begin += damage.size())
+        {
+            const size_t count = std::min(damage.size(), attackers.size() - begin);
+            gatherSum(attackers.subspan(begin, count), players.strength.data(), players.intelligence.data(), damage.data());
+            for (size_t i = 0; i < count; i++) // In order, so an attacker's casts fail once its magic is spent
+            {
+                const uint32_t a = attackers[begin + i];
+                if (deltas.magicSpent[a] >= players.magic[a]) continue;
+                deltas.magicSpent[a]++;
+                deltas.damage[targets[begin + i]] = saturatingAdd(deltas.damage[targets[begin + i]], damage[i]);
+            }
+        }
+    }
 };
 
+using ClosedAttack = std::variant<PhysicalAttack, MagicAttack>; // Built-in strategies; plugins keep using AttackStrategy
+
+class StaticPlayer // Player whose strategy is picked from ClosedAttack, so attacks dispatch on the variant index and inline
+{
+public:
+    StaticPlayer(Player::State state, ClosedAttack attackStrategy) :
+        state{ state }, attackStrategy{ attackStrategy } { };
+public:
+    Player::State& getState() { return this->state; }
+    bool attack(StaticPlayer& target)
+    {
+        return std::visit([&](const auto& strategy) { return strategy.apply(this->state, target.state); }, this->attackStrategy);
+    }
+protected:
+    Player::State state;
+    ClosedAttack attackStrategy;
+};
+
+struct AttackOrder
+{
+    uint32_t attacker;
+    uint32_t target;
+    AttackStrategy* strategy;
+};
+
+class CombatTick // Resolves a tick of attacks over PlayerColumns, one accumulate() call per distinct strategy
+{
+public:
+    void resolve(PlayerColumns& players, std::span<const AttackOrder> orders) // Damage commutes; magic is spent strategy by strategy in order of first appearance
+    {
+        this->deltas.reset(players.count());
+        this->accumulate(players, orders, this->deltas);
+        subtractSaturating(players.health, this->deltas.damage);
+        subtractSaturating(players.magic, this->deltas.magicSpent);
+    }
+    void accumulate(const PlayerColumns& players, std::span<const AttackOrder> orders, CombatDeltas& deltas,
+        std::span<AttackStrategy* const> strategyOrder = {}) // Without applying; strategyOrder overrides which strategies go first
+    {
+        this->group(orders, strategyOrder);
+        for (size_t i = 0; i < this->activeGroups; i++)
+            if (!this->groups[i].attackers.empty())
+                this->groups[i].strategy->accumulate(players, this->groups[i].attackers, this->groups[i].targets, deltas);
+    }
+protected:
+    struct Group
+    {
+        AttackStrategy* strategy;
+        std::vector<uint32_t> attackers;
+        std::vector<uint32_t> targets;
+    };
+
+    Group& activate(AttackStrategy* strategy) // Moves the strategy's group to the end of this tick's order, keeping its buffers
+    {
+        auto found = std::ranges::find(this->groups, strategy, &Group::strategy);
+        if (found - this->groups.begin() < static_cast<std::ptrdiff_t>(this->activeGroups)) return *found;
+        if (found == this->groups.end()) found = this->groups.insert(this->groups.end(), Group{ strategy, {}, {} });
+        std::swap(*found, this->groups[this->activeGroups]);
+        return this->groups[this->activeGroups++];
+    }
+    void group(std::span<const AttackOrder> orders, std::span<AttackStrategy* const> strategyOrder) // Stable: orders keep their relative order within a strategy
+    {
+        for (auto& group : this->groups)
+        {
+            group.attackers.clear();
+            group.targets.clear();
+        }
+        this->activeGroups = 0; // The order is rebuilt every tick, a previous tick's first appearances must not carry over
+        for (AttackStrategy* strategy : strategyOrder)
+            this->activate(strategy);
+        Group* last = nullptr;
+        for (const auto& order : orders)
+        {
+            if (!last || last->strategy != order.strategy) last = &this->activate(order.strategy);
+            last->attackers.push_back(order.attacker);
+            last->targets.push_back(order.target);
+        }
+    }
+protected:
+    std::vector<Group> groups; // The first activeGroups are this tick's, in order; the rest keep their buffers for later ticks
+    size_t activeGroups = 0;
+    CombatDeltas deltas;
+};
+
+class ParallelCombatTick // CombatTick across threads; a tick gives results bit-identical to CombatTick on any thread count
+{
+public:
+    explicit ParallelCombatTick(size_t threads = std::thread::hardware_concurrency()) :
+        workers(std::max<size_t>(threads, 1)), sync{ static_cast<std::ptrdiff_t>(std::max<size_t>(threads, 1)) }
+    {
+        for (size_t w = 1; w < this->workers.size(); w++)
+        {
+            this->threads.emplace_back([this, w]
+            {
+                for (;;)
+                {
+                    this->sync.arrive_and_wait();
+                    if (this->stopping) return;
+                    this->work(w);
+                }
+            });
+        }
+    }
+    ~ParallelCombatTick()
+    {
+        this->stopping = true;
+        this->sync.arrive_and_wait();
+    }
+
+    // Strategies up to the first one that does not partition by attacker run in parallel. That one and everything
+    // after it in strategy order see the damage of the whole tick so far, so they run on the caller through CombatTick.
+    void resolve(PlayerColumns& players, std::span<const AttackOrder> orders)
+    {
+        this->players = &players;
+        this->orders = orders;
+        this->sync.arrive_and_wait();
+        this->work(0); // The caller takes worker 0's share
+
+        const std::vector<AttackStrategy*>& serial = this->workers[0].serialStrategies;
+        if (serial.empty()) return;
+        this->serialOrders.clear();
+        for (const AttackOrder& order : orders)
+            if (std::ranges::find(serial, order.strategy) != serial.end()) this->serialOrders.push_back(order);
+        this->serialTick.resolve(players, this->serialOrders);
+    }
+    size_t countThreads() const { return this->workers.size(); }
+protected:
+    struct Worker
+    {
+        std::vector<std::vector<AttackOrder>> outbox; // Orders from this worker's slice, bucketed by the worker owning the attacker
+        std::vector<AttackStrategy*> seen; // Strategies of the slice in order of first appearance
+        std::vector<AttackOrder> inbox; // Every order of this worker's attackers, in tick order
+        std::vector<AttackStrategy*> strategyOrder;
+        std::vector<AttackStrategy*> serialStrategies; // The tail of the tick's strategy order that is left to the caller
+        CombatTick tick;
+        CombatDeltas deltas;
+    };
+
+    void work(size_t w)
+    {
+        const size_t count = this->workers.size();
+        Worker& self = this->workers[w];
+        PlayerColumns& players = *this->players;
+
+        self.outbox.resize(count); // Phase 1: route a contiguous slice of orders to the owners of their attackers
+        for (auto& box : self.outbox)
+            box.clear();
+        self.seen.clear();
+        for (size_t i = this->orders.size() * w / count; i < this->orders.size() * (w + 1) / count; i++)
+        {
+            const AttackOrder& order = this->orders[i];
+            self.outbox[order.attacker % count].push_back(order);
+            if (self.seen.empty() || self.seen.back() != order.strategy)
+                if (std::ranges::find(self.seen, order.strategy) == self.seen.end()) self.seen.push_back(order.strategy);
+        }
+        if (self.deltas.damage.size() != players.count()) self.deltas.reset(players.count());
+        this->sync.arrive_and_wait();
+
+        self.inbox.clear(); // Phase 2: an attacker's orders all land here in tick order, so its magic runs out exactly as in CombatTick
+        self.strategyOrder.clear();
+        for (const Worker& source : this->workers)
+        {
+            self.inbox.insert(self.inbox.end(), source.outbox[w].begin(), source.outbox[w].end());
+            for (AttackStrategy* strategy : source.seen)
+                if (std::ranges::find(self.strategyOrder, strategy) == self.strategyOrder.end()) self.strategyOrder.push_back(strategy);
+        }
+        const auto serial = std::ranges::find_if(self.strategyOrder, [](AttackStrategy* strategy) { return !strategy->partitionsByAttacker(); });
+        self.serialStrategies.assign(serial, self.strategyOrder.end());
+        self.strategyOrder.erase(serial, self.strategyOrder.end());
+        if (!self.serialStrategies.empty())
+            std::erase_if(self.inbox, [&](const AttackOrder& order) { return std::ranges::find(self.strategyOrder, order.strategy) == self.strategyOrder.end(); });
+        self.tick.accumulate(players, self.inbox, self.deltas, self.strategyOrder); // Same strategy order as the whole tick
+        this->sync.arrive_and_wait();
+
+        const size_t begin = (players.count() * w / count) & ~size_t{ 15 }; // Phase 3: reduce a cache-line aligned range of players
+        const size_t end = w + 1 == count ? players.count() : (players.count() * (w + 1) / count) & ~size_t{ 15 };
+        for (Worker& source : this->workers) // Iterated saturating subtraction equals subtracting the saturated sum, in any order
+        {
+            subtractSaturating(std::span{ players.health }.subspan(begin, end - begin), std::span{ source.deltas.damage }.subspan(begin, end - begin));
+            subtractSaturating(std::span{ players.magic }.subspan(begin, end - begin), std::span{ source.deltas.magicSpent }.subspan(begin, end - begin));
+            std::fill(source.deltas.damage.begin() + begin, source.deltas.damage.begin() + end, 0);
+            std::fill(source.deltas.magicSpent.begin() + begin, source.deltas.magicSpent.begin() + end, 0);
+        }
+        this->sync.arrive_and_wait();
+    }
+protected:
+    std::vector<Worker> workers;
+    std::barrier<> sync;
+    bool stopping = false;
+    PlayerColumns* players = nullptr;
+    std::span<const AttackOrder> orders;
+    std::vector<AttackOrder> serialOrders;
+    CombatTick serialTick;
+    std::vector<std::jthread> threads; // Last, so workers are joined before the state they use goes away
+};
+
+void benchmarkCombat()
+{
+    constexpr size_t players = 100'000;
+    constexpr size_t attacksPerTick = 300'000;
+    constexpr size_t ticks = 50;
+    auto skill_slash = std::make_shared<PhysicalAttack>();
+    auto skill_fireBall = std::make_shared<MagicAttack>();
+    std::mt19937 random{ 1 };
+    auto roll = [&](uint32_t bound) { return static_cast<uint32_t>(random() % bound); };
+
+    PlayerColumns columns{};
+    std::vector<Player> objects{};
+    for (size_t i = 0; i < players; i++)
+    {
+        const Player::State state{ .health = 1'000'000, .magic = roll(64), .strength = roll(16), .intelligence = roll(16) };
+        columns.add(state);
+        objects.emplace_back(state, i % 2 ? std::shared_ptr<AttackStrategy>{ skill_fireBall } : std::shared_ptr<AttackStrategy>{ skill_slash });
+    }
+    std::vector<AttackOrder> orders(attacksPerTick);
+    for (auto& order : orders)
+    {
+        order.attacker = roll(players);
+        order.target = roll(players);
+        order.strategy = order.attacker % 2 ? static_cast<AttackStrategy*>(skill_fireBall.get()) : skill_slash.get();
+    }
+
+    AttackStrategy::log = nullptr;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t tick = 0; tick < ticks; tick++)
+        for (const auto& order : orders)
+            objects[order.attacker].attack(objects[order.target]);
+    const double virtualSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    AttackStrategy::log = &std::cout;
+
+    CombatTick combat{};
+    begin = std::chrono::steady_clock::now();
+    for (size_t tick = 0; tick < ticks; tick++)
+        combat.resolve(columns, orders);
+    const double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    size_t mismatches{ 0 };
+    for (uint32_t i = 0; i < players; i++)
+        mismatches += columns.health[i] != objects[i].getState().health || columns.magic[i] != objects[i].getState().magic;
+    std::cout << std::format("[Per-call virtual] {:.1f} ticks/s\n", ticks / virtualSeconds);
+    std::cout << std::format("[Batch kernels   ] {:.1f} ticks/s ({} attacks/tick, {} mismatches)\n", ticks / batchSeconds, attacksPerTick, mismatches);
+}
+
+void benchmarkDispatch() // Per-attack call overhead of the vtable and the variant, with the strategy sequence easy or hard to predict
+{
+    constexpr size_t players = 4096;
+    constexpr size_t attacks = 20'000'000;
+    auto skill_slash = std::make_shared<PhysicalAttack>();
+    auto skill_fireBall = std::make_shared<MagicAttack>();
+    std::mt19937 random{ 1 };
+
+    AttackStrategy::log = nullptr;
+    for (const bool predictable : { true, false })
+    {
+        std::vector<Player> objects{};
+        std::vector<StaticPlayer> closed{};
+        for (size_t i = 0; i < players; i++)
+        {
+            const bool magic = predictable ? i < players / 2 : random() % 2; // Runs of one strategy, or a coin flip per player
+            const Player::State state{ .health = std::numeric_limits<uint32_t>::max(), .magic = std::numeric_limits<uint32_t>::max(),
+                .strength = 1, .intelligence = 1 };
+            objects.emplace_back(state, magic ? std::shared_ptr<AttackStrategy>{ skill_fireBall } : std::shared_ptr<AttackStrategy>{ skill_slash });
+            closed.emplace_back(state, magic ? ClosedAttack{ MagicAttack{} } : ClosedAttack{ PhysicalAttack{} });
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < attacks; i++)
+            objects[i % players].attack(objects[(i * 7 + 1) % players]);
+        const double virtualSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < attacks; i++)
+            closed[i % players].attack(closed[(i * 7 + 1) % players]);
+        const double variantSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        std::cout << std::format("[{:<11} mix] virtual {:.2f} ns/attack, variant {:.2f} ns/attack\n",
+            predictable ? "Predictable" : "Random", virtualSeconds * 1e9 / attacks, variantSeconds * 1e9 / attacks);
+    }
+    AttackStrategy::log = &std::cout;
+    std::cout << std::format("[Object size] Player {} bytes + shared strategy, StaticPlayer {} bytes (code size: nm -S on the build)\n",
+        sizeof(Player), sizeof(StaticPlayer));
+}
+
+void benchmarkParallelCombat()
+{
+    constexpr size_t players = 100'000;
+    constexpr size_t attacksPerTick = 1'000'000;
+    constexpr size_t ticks = 20;
+    auto skill_slash = std::make_shared<PhysicalAttack>();
+    auto skill_fireBall = std::make_shared<MagicAttack>();
+    std::mt19937 random{ 2 };
+    auto roll = [&](uint32_t bound) { return static_cast<uint32_t>(random() % bound); };
+
+    PlayerColumns initial{};
+    for (size_t i = 0; i < players; i++)
+        initial.add(Player::State{ .health = roll(5'000), .magic = roll(32), .strength = roll(16), .intelligence = roll(16) });
+    std::vector<AttackOrder> orders(attacksPerTick);
+    for (auto& order : orders)
+    {
+        order.attacker = roll(players);
+        order.target = roll(players);
+        order.strategy = roll(2) ? static_cast<AttackStrategy*>(skill_fireBall.get()) : skill_slash.get();
+    }
+    auto fingerprint = [](const PlayerColumns& columns) // FNV-1a over health and magic
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < columns.count(); i++)
+            hash = ((hash ^ columns.health[i]) * 1099511628211ull ^ columns.magic[i]) * 1099511628211ull;
+        return hash;
+    };
+
+    PlayerColumns reference = initial;
+    CombatTick sequential{};
+    for (size_t tick = 0; tick < ticks; tick++)
+        sequential.resolve(reference, orders);
+
+    double baseline{ 0 };
+    for (size_t threads = 1; threads <= 64; threads *= 2)
+    {
+        PlayerColumns columns = initial;
+        ParallelCombatTick combat{ threads };
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t tick = 0; tick < ticks; tick++)
+            combat.resolve(columns, orders);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (threads == 1) baseline = seconds;
+        std::cout << std::format("[Parallel x{:>2}] {:.1f} ticks/s, speedup {:.2f}, {}\n", threads, ticks / seconds, baseline / seconds,
+            fingerprint(columns) == fingerprint(reference) ? "identical to CombatTick" : "MISMATCH");
+    }
+}
+
+class CrushingBlow // A plugin strategy: it reads the target's health, so it goes through the default accumulate() and its order matters
+    :public AttackStrategy
+{
+public:
+    bool operator()(Player& attacker, Player& target) override
+    {
+        Player::State& st = target.getState();
+        const uint32_t damage = saturatingAdd(attacker.getState().strength, st.health / 10); // A tenth of what is left on top
+        st.health = saturatingSub(st.health, damage);
+        if (log) *log << std::format("Crushing Blow Damage: {}\n", damage);
+        return true;
+    }
+};
+
+struct CombatScenario // Ticks whose strategies first appear in a different order each time, with a health-reading plugin among them
+{
+    CombatScenario(size_t players, size_t attacksPerTick, size_t ticks) :orders(ticks, std::vector<AttackOrder>(attacksPerTick))
+    {
+        AttackStrategy* const strategies[]{ &this->slash, &this->fireBall, &this->crush };
+        std::mt19937 random{ 3 };
+        auto roll = [&](uint32_t bound) { return static_cast<uint32_t>(random() % bound); };
+        for (size_t i = 0; i < players; i++)
+            this->initial.add(Player::State{ .health = 2'000 + roll(2'000), .magic = roll(8), .strength = 1 + roll(16), .intelligence = roll(16) });
+        for (size_t tick = 0; tick < ticks; tick++)
+        {
+            for (auto& order : this->orders[tick])
+                order = AttackOrder{ roll(static_cast<uint32_t>(players)), roll(static_cast<uint32_t>(players)), strategies[roll(3)] };
+            this->orders[tick][0].strategy = strategies[tick % 3]; // Rotates and flips which strategy comes first
+            this->orders[tick][1].strategy = strategies[(tick + 2) % 3];
+        }
+    }
+    CombatScenario(const CombatScenario&) = delete; // Orders point at the strategies above
+
+    template <typename Tick>
+    PlayerColumns play(Tick& combat) const // Every tick through the same, long-lived resolver
+    {
+        std::ostream* const log = AttackStrategy::log;
+        AttackStrategy::log = nullptr;
+        PlayerColumns columns = this->initial;
+        for (const auto& tick : this->orders)
+            combat.resolve(columns, tick);
+        AttackStrategy::log = log;
+        return columns;
+    }
+
+    PhysicalAttack slash{};
+    MagicAttack fireBall{};
+    CrushingBlow crush{};
+    PlayerColumns initial{};
+    std::vector<std::vector<AttackOrder>> orders;
+};
+
+bool checkCombatTicks() // A reused CombatTick must match a fresh one per tick
+{
+    const CombatScenario scenario{ 64, 512, 6 };
+    CombatTick combat{};
+    const PlayerColumns reused = scenario.play(combat);
+
+    PlayerColumns fresh = scenario.initial;
+    std::ostream* const log = AttackStrategy::log;
+    AttackStrategy::log = nullptr;
+    for (const auto& tick : scenario.orders)
+        CombatTick{}.resolve(fresh, tick);
+    AttackStrategy::log = log;
+    return reused.health == fresh.health && reused.magic == fresh.magic;
+}
+
+bool checkParallelCombat(size_t threads) // ParallelCombatTick must match CombatTick tick after tick, plugin strategies included
+{
+    const CombatScenario scenario{ 1024, 8192, 6 };
+    CombatTick sequential{};
+    ParallelCombatTick parallel{ threads };
+    const PlayerColumns expected = scenario.play(sequential);
+    const PlayerColumns actual = scenario.play(parallel);
+    return actual.health == expected.health && actual.magic == expected.magic;
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkCombat();
+        benchmarkDispatch();
+        benchmarkParallelCombat();
+        return EXIT_SUCCESS;
+    }
+
     auto skill_slash = std::make_shared<PhysicalAttack>();
     auto skill_fireBall = std::make_shared<MagicAttack>();
 
@@ -102,6 +665,35 @@ int main(int argc, char* argv[])
     mercenary.attack(magician);
     std::cout << "Magician -> Mercenary\n";
     magician.attack(mercenary);
+
+    PlayerColumns columns{};
+    const uint32_t mercenaryID = columns.add(mercenary.getState());
+    const uint32_t magicianID = columns.add(magician.getState());
+    const std::vector<AttackOrder> orders
+    {
+        { mercenaryID, magicianID, skill_slash.get() },
+        { magicianID, mercenaryID, skill_fireBall.get() },
+        { mercenaryID, magicianID, skill_slash.get() }, // Saturates at 0 health
+    };
+    CombatTick combat{};
+    combat.resolve(columns, orders);
+    std::cout << std::format("Batch tick: mercenary HP {}, magician HP {} MP {}\n",
+        columns.health[mercenaryID], columns.health[magicianID], columns.magic[magicianID]);
+
+    ParallelCombatTick parallelCombat{ 4 };
+    parallelCombat.resolve(columns, orders);
+    std::cout << std::format("Parallel tick on {} threads: mercenary HP {}, magician HP {} MP {}\n", parallelCombat.countThreads(),
+        columns.health[mercenaryID], columns.health[magicianID], columns.magic[magicianID]);
+    std::cout << std::format("Reused CombatTick over ticks with changing strategy order: {}\n", checkCombatTicks() ? "matches fresh ticks" : "MISMATCH");
+    for (size_t threads : { size_t{ 1 }, size_t{ 2 }, std::max<size_t>(std::thread::hardware_concurrency(), 3) })
+        std::cout << std::format("Parallel ticks with a plugin strategy on {} thread(s): {}\n", threads, checkParallelCombat(threads) ? "identical to CombatTick" : "MISMATCH");
+
+    StaticPlayer knight{ Player::State{ .health = 12, .magic = 0, .strength = 4, .intelligence = 1 }, PhysicalAttack{} };
+    StaticPlayer warlock{ Player::State{ .health = 7, .magic = 5, .strength = 1, .intelligence = 6 }, MagicAttack{} };
+    std::cout << "Knight -> Warlock\n";
+    knight.attack(warlock);
+    std::cout << "Warlock -> Knight\n";
+    warlock.attack(knight);
     
     return EXIT_SUCCESS;
 }
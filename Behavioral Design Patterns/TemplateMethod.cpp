@@ -12,77 +12,2534 @@ Note: Similar to Builder whereas the Builder is a Creational Pattern.
 #include <format>
 #include <vector>
 #include <memory>
+#include <span>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <array>
+#include <variant>
+#include <unordered_map>
+#include <unordered_set>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+class MappedFile // Whole file mapped read-only; the views it hands out live as long as the mapping
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        this->file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (this->file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER size{};
+        ::GetFileSizeEx(this->file, &size);
+        this->size = static_cast<size_t>(size.QuadPart);
+        this->opened = true;
+        if (this->size == 0) return;
+        this->mapping = ::CreateFileMappingW(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (this->mapping) this->data = static_cast<const char*>(::MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info{};
+        if (::fstat(fd, &info) == 0)
+        {
+            this->size = static_cast<size_t>(info.st_size);
+            this->opened = true;
+            if (this->size > 0)
+            {
+                void* view = ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+                this->data = view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+                if (this->data) ::madvise(view, this->size, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd); // The mapping keeps the file alive
+#endif
+        this->opened = this->opened && (this->size == 0 || this->data);
+    }
+    ~MappedFile() { this->close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other) return *this;
+        this->close();
+        this->data = std::exchange(other.data, nullptr);
+        this->size = std::exchange(other.size, 0);
+        this->opened = std::exchange(other.opened, false);
+#if defined(_WIN32)
+        this->file = std::exchange(other.file, INVALID_HANDLE_VALUE);
+        this->mapping = std::exchange(other.mapping, nullptr);
+#endif
+        return *this;
+    }
+public:
+    bool isOpen() const { return this->opened; }
+    std::string_view view() const { return this->data ? std::string_view{ this->data, this->size } : std::string_view{}; }
+protected:
+    void close()
+    {
+#if defined(_WIN32)
+        if (this->data) ::UnmapViewOfFile(this->data);
+        if (this->mapping) ::CloseHandle(this->mapping);
+        if (this->file != INVALID_HANDLE_VALUE) ::CloseHandle(this->file);
+        this->file = INVALID_HANDLE_VALUE;
+        this->mapping = nullptr;
+#else
+        if (this->data) ::munmap(const_cast<char*>(this->data), this->size);
+#endif
+        this->data = nullptr;
+        this->size = 0;
+        this->opened = false;
+    }
+protected:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool opened = false;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
+
+class CSVTokenizer // RFC 4180 records split into field views, classifying 64 bytes per step
+{
+public:
+    explicit CSVTokenizer(char delimiter = ',', bool vectorized = true) :
+        delimiter{ delimiter }, vectorized{ vectorized } { };
+public:
+    template<typename OnRecord> // void(std::span<const std::string_view> fields), views point into text
+    size_t tokenize(std::string_view text, OnRecord&& onRecord) const // Returns the number of records
+    {
+        size_t consumed{ 0 };
+        return this->scan(text, onRecord, true, consumed);
+    }
+    template<typename OnRecord>
+    size_t tokenizeComplete(std::string_view text, OnRecord&& onRecord) const // Stops at the last newline outside quotes, returns the bytes up to it
+    {
+        size_t consumed{ 0 };
+        this->scan(text, onRecord, false, consumed);
+        return consumed;
+    }
+
+    static std::string_view trimQuotes(std::string_view field) // Still zero-copy, so doubled quotes inside stay doubled
+    {
+        if (field.size() >= 2 && field.front() == '"' && field.back() == '"') return field.substr(1, field.size() - 2);
+        return field;
+    }
+protected:
+    struct Masks
+    {
+        uint64_t delimiter = 0;
+        uint64_t newline = 0;
+        uint64_t quote = 0;
+    };
+
+    template<typename OnRecord>
+    size_t scan(std::string_view text, OnRecord& onRecord, bool flushTail, size_t& consumed) const
+    {
+        std::vector<std::string_view> fields{};
+        size_t records{ 0 };
+        size_t fieldBegin{ 0 };
+        uint64_t insideQuotes{ 0 }; // All ones while a quoted field continues into the next block
+        for (size_t base = 0; base < text.size(); base += 64)
+        {
+            const Masks masks = this->classify(text, base);
+            const uint64_t quoted = prefixXor(masks.quote) ^ insideQuotes;
+            insideQuotes = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+            for (uint64_t structural = (masks.delimiter | masks.newline) & ~quoted; structural; structural &= structural - 1)
+            {
+                const size_t bit = static_cast<size_t>(std::countr_zero(structural));
+                const size_t position = base + bit;
+                std::string_view field = text.substr(fieldBegin, position - fieldBegin);
+                fieldBegin = position + 1;
+                if (masks.delimiter >> bit & 1)
+                {
+                    fields.push_back(field);
+                    continue;
+                }
+                consumed = fieldBegin;
+                if (!field.empty() && field.back() == '\r') field.remove_suffix(1);
+                if (!fields.empty() || !field.empty()) // Blank lines carry no record
+                {
+                    fields.push_back(field);
+                    onRecord(std::span<const std::string_view>{ fields });
+                    records++;
+                }
+                fields.clear();
+            }
+        }
+        if (flushTail && (fieldBegin < text.size() || !fields.empty())) // Last record without a trailing newline
+        {
+            fields.push_back(text.substr(fieldBegin));
+            onRecord(std::span<const std::string_view>{ fields });
+            records++;
+            consumed = text.size();
+        }
+        return records;
+    }
+
+    static uint64_t prefixXor(uint64_t bits) // Bit i becomes the parity of quotes at or before i
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    Masks classify(std::string_view text, size_t base) const
+    {
+        const size_t available = text.size() - base;
+        if (available < 64 || !this->vectorized) // Tail block, or the scalar reference path
+        {
+            Masks masks{};
+            for (size_t i = 0; i < std::min<size_t>(available, 64); i++)
+            {
+                const char c = text[base + i];
+                masks.delimiter |= uint64_t{ c == this->delimiter } << i;
+                masks.newline |= uint64_t{ c == '\n' } << i;
+                masks.quote |= uint64_t{ c == '"' } << i;
+            }
+            return masks;
+        }
+        const char* block = text.data() + base;
+#if defined(__AVX2__)
+        auto match = [&](char c)
+        {
+            const __m256i needle = _mm256_set1_epi8(c);
+            const uint32_t low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), needle)));
+            const uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), needle)));
+            return uint64_t{ low } | uint64_t{ high } << 32;
+        };
+        return Masks{ match(this->delimiter), match('\n'), match('"') };
+#elif defined(__SSE2__) || defined(_M_X64)
+        auto match = [&](char c)
+        {
+            const __m128i needle = _mm_set1_epi8(c);
+            uint64_t bits{ 0 };
+            for (size_t i = 0; i < 4; i++)
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+                bits |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle))) } << (i * 16);
+            }
+            return bits;
+        };
+        return Masks{ match(this->delimiter), match('\n'), match('"') };
+#else
+        Masks masks{};
+        for (size_t i = 0; i < 64; i++)
+        {
+            masks.delimiter |= uint64_t{ block[i] == this->delimiter } << i;
+            masks.newline |= uint64_t{ block[i] == '\n' } << i;
+            masks.quote |= uint64_t{ block[i] == '"' } << i;
+        }
+        return masks;
+#endif
+    }
+protected:
+    char delimiter;
+    bool vectorized;
+};
+
+class ColumnarCache // Typed columns of a parsed CSV file, written next to it and memory-mapped on later runs
+{
+public:
+    enum class Type : uint64_t { Int64, Double, String };
+
+    struct Stamp // Identifies the source a cache was built from
+    {
+        uint64_t size = 0;
+        int64_t modified = 0;
+        uint64_t hash = 0; // 0 when the source was not hashed
+
+        static Stamp of(const std::filesystem::path& source, std::string_view text = {}) // Hashes text when it is given
+        {
+            std::error_code error{};
+            Stamp stamp{};
+            stamp.size = std::filesystem::file_size(source, error);
+            stamp.modified = std::filesystem::last_write_time(source, error).time_since_epoch().count();
+            if (!text.empty()) stamp.hash = hashBytes(text);
+            return stamp;
+        }
+    };
+
+    struct Column
+    {
+        std::string_view name;
+        Type type;
+        double min; // Numeric columns only
+        double max;
+        const char* data;
+        const double* groupStats; // Min and max of every row group, for skipping
+    };
+
+    struct RangeCount
+    {
+        size_t rows = 0;
+        size_t skippedGroups = 0;
+    };
+
+    static constexpr uint64_t GroupRows = 65536;
+public:
+    static bool build(std::string_view text, const CSVTokenizer& tokenizer, const std::filesystem::path& path, const Stamp& stamp)
+    {
+        std::vector<std::string> names{}; // Pass 1: header, shape and the narrowest type every value of a column parses as
+        std::vector<Type> types{};
+        std::vector<uint64_t> stringBytes{};
+        uint64_t rows{ 0 };
+        bool rectangular = true;
+        tokenizer.tokenize(text, [&](std::span<const std::string_view> record)
+        {
+            if (names.empty())
+            {
+                for (auto field : record)
+                    names.emplace_back(CSVTokenizer::trimQuotes(field));
+                types.assign(names.size(), Type::Int64);
+                stringBytes.assign(names.size(), 0);
+                return;
+            }
+            if (record.size() != names.size())
+            {
+                rectangular = false;
+                return;
+            }
+            for (size_t i = 0; i < record.size(); i++)
+            {
+                const std::string_view value = CSVTokenizer::trimQuotes(record[i]);
+                int64_t integer{};
+                double real{};
+                if (types[i] == Type::Int64 && !parse(value, integer)) types[i] = Type::Double;
+                if (types[i] == Type::Double && !parse(value, real)) types[i] = Type::String;
+                stringBytes[i] += value.size();
+            }
+            rows++;
+        });
+        if (names.empty() || !rectangular) return false; // Ragged files stay text only
+
+        const size_t groups = static_cast<size_t>((rows + GroupRows - 1) / GroupRows);
+        std::vector<std::vector<int64_t>> integers(names.size()); // Pass 2: typed values and statistics
+        std::vector<std::vector<double>> reals(names.size());
+        std::vector<std::vector<uint64_t>> offsets(names.size());
+        std::vector<std::string> strings(names.size());
+        std::vector<std::vector<double>> stats(names.size());
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (types[i] == Type::Int64) integers[i].reserve(rows);
+            if (types[i] == Type::Double) reals[i].reserve(rows);
+            if (types[i] == Type::String)
+            {
+                offsets[i].reserve(rows + 1);
+                offsets[i].push_back(0);
+                strings[i].reserve(stringBytes[i]);
+            }
+            else stats[i].assign(groups * 2 + 2, 0.0); // Every group, then the whole column
+        }
+        uint64_t row{ 0 };
+        bool header = true;
+        tokenizer.tokenize(text, [&](std::span<const std::string_view> record)
+        {
+            if (std::exchange(header, false)) return;
+            const size_t group = static_cast<size_t>(row / GroupRows);
+            for (size_t i = 0; i < record.size(); i++)
+            {
+                const std::string_view value = CSVTokenizer::trimQuotes(record[i]);
+                double number{};
+                if (types[i] == Type::String)
+                {
+                    strings[i] += value;
+                    offsets[i].push_back(strings[i].size());
+                    continue;
+                }
+                if (types[i] == Type::Int64)
+                {
+                    int64_t integer{};
+                    parse(value, integer);
+                    integers[i].push_back(integer);
+                    number = static_cast<double>(integer);
+                }
+                else
+                {
+                    parse(value, number);
+                    reals[i].push_back(number);
+                }
+                for (size_t slot : { group, groups })
+                {
+                    double& low = stats[i][slot * 2];
+                    double& high = stats[i][slot * 2 + 1];
+                    const bool first = slot == group ? row % GroupRows == 0 : row == 0;
+                    low = first ? number : std::min(low, number);
+                    high = first ? number : std::max(high, number);
+                }
+            }
+            row++;
+        });
+
+        FileHeader fileHeader{ .rows = rows, .columns = names.size(), .stamp = stamp };
+        std::vector<ColumnHeader> columnHeaders(names.size());
+        uint64_t offset = align(sizeof(FileHeader) + sizeof(ColumnHeader) * names.size());
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            ColumnHeader& column = columnHeaders[i];
+            column.type = types[i];
+            column.nameOffset = offset;
+            column.nameLength = names[i].size();
+            offset = align(offset + names[i].size());
+            column.dataOffset = offset;
+            offset = align(offset + (types[i] == Type::String ? (rows + 1) * sizeof(uint64_t) + strings[i].size() : rows * 8));
+            if (types[i] == Type::String) continue;
+            column.statsOffset = offset;
+            column.min = stats[i][groups * 2];
+            column.max = stats[i][groups * 2 + 1];
+            offset = align(offset + groups * 2 * sizeof(double));
+        }
+
+        const auto temporary = std::filesystem::path{ path } += ".tmp"; // Renamed into place once complete
+        {
+            std::ofstream output{ temporary, std::ios::binary | std::ios::trunc };
+            auto write = [&](const void* bytes, size_t size, uint64_t at)
+            {
+                while (static_cast<uint64_t>(output.tellp()) < at) output.put('\0');
+                output.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+            };
+            write(&fileHeader, sizeof(fileHeader), 0);
+            write(columnHeaders.data(), sizeof(ColumnHeader) * columnHeaders.size(), sizeof(fileHeader));
+            for (size_t i = 0; i < names.size(); i++)
+            {
+                const ColumnHeader& column = columnHeaders[i];
+                write(names[i].data(), names[i].size(), column.nameOffset);
+                if (types[i] == Type::Int64) write(integers[i].data(), integers[i].size() * sizeof(int64_t), column.dataOffset);
+                if (types[i] == Type::Double) write(reals[i].data(), reals[i].size() * sizeof(double), column.dataOffset);
+                if (types[i] == Type::String)
+                {
+                    write(offsets[i].data(), offsets[i].size() * sizeof(uint64_t), column.dataOffset);
+                    write(strings[i].data(), strings[i].size(), column.dataOffset + offsets[i].size() * sizeof(uint64_t));
+                }
+                else write(stats[i].data(), groups * 2 * sizeof(double), column.statsOffset);
+            }
+            while (static_cast<uint64_t>(output.tellp()) < offset) output.put('\0');
+            if (!output) return false;
+        }
+        std::error_code error{};
+        std::filesystem::rename(temporary, path, error);
+        return !error;
+    }
+
+    bool open(const std::filesystem::path& path, const Stamp& expected) // Fails when the cache is missing, corrupt or stale
+    {
+        this->columns.clear();
+        MappedFile mapped{ path };
+        const std::string_view bytes = mapped.view();
+        if (bytes.size() < sizeof(FileHeader)) return false;
+        FileHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, FileHeader{}.magic, sizeof(header.magic)) != 0) return false;
+        if (header.stamp.size != expected.size || header.stamp.modified != expected.modified) return false;
+        if (expected.hash != 0 && header.stamp.hash != expected.hash) return false;
+        if (bytes.size() < sizeof(FileHeader) + sizeof(ColumnHeader) * header.columns) return false;
+
+        const size_t groups = static_cast<size_t>((header.rows + GroupRows - 1) / GroupRows);
+        for (uint64_t i = 0; i < header.columns; i++)
+        {
+            ColumnHeader column{};
+            std::memcpy(&column, bytes.data() + sizeof(FileHeader) + sizeof(ColumnHeader) * i, sizeof(column));
+            const uint64_t dataBytes = column.type == Type::String ? (header.rows + 1) * sizeof(uint64_t) : header.rows * 8;
+            if (column.nameOffset + column.nameLength > bytes.size() || column.dataOffset + dataBytes > bytes.size()) return false;
+            if (column.type != Type::String && column.statsOffset + groups * 2 * sizeof(double) > bytes.size()) return false;
+            this->columns.push_back(Column{ bytes.substr(column.nameOffset, column.nameLength), column.type, column.min, column.max,
+                bytes.data() + column.dataOffset,
+                column.type == Type::String ? nullptr : reinterpret_cast<const double*>(bytes.data() + column.statsOffset) }); // 8-byte aligned offsets
+        }
+        this->rows = header.rows;
+        this->file = std::move(mapped);
+        return true;
+    }
+
+    size_t countRows() const { return static_cast<size_t>(this->rows); }
+    size_t countColumns() const { return this->columns.size(); }
+    const Column& getColumn(size_t column) const { return this->columns[column]; }
+    std::optional<size_t> findColumn(std::string_view name) const
+    {
+        for (size_t i = 0; i < this->columns.size(); i++)
+            if (this->columns[i].name == name) return i;
+        return std::nullopt;
+    }
+
+    int64_t getInt(size_t column, size_t row) const { return reinterpret_cast<const int64_t*>(this->columns[column].data)[row]; }
+    double getDouble(size_t column, size_t row) const { return reinterpret_cast<const double*>(this->columns[column].data)[row]; }
+    std::string_view getString(size_t column, size_t row) const
+    {
+        const auto* offsets = reinterpret_cast<const uint64_t*>(this->columns[column].data);
+        const char* bytes = this->columns[column].data + (this->rows + 1) * sizeof(uint64_t);
+        return std::string_view{ bytes + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row]) };
+    }
+
+    RangeCount countInRange(size_t column, double low, double high) const // Rows of a numeric column within [low, high]
+    {
+        const Column& target = this->columns[column];
+        RangeCount count{};
+        for (size_t group = 0; group * GroupRows < this->rows; group++)
+        {
+            if (target.groupStats[group * 2 + 1] < low || target.groupStats[group * 2] > high)
+            {
+                count.skippedGroups++;
+                continue;
+            }
+            const size_t end = static_cast<size_t>(std::min<uint64_t>((group + 1) * GroupRows, this->rows));
+            for (size_t row = group * GroupRows; row < end; row++)
+            {
+                const double value = target.type == Type::Int64 ? static_cast<double>(this->getInt(column, row)) : this->getDouble(column, row);
+                count.rows += value >= low && value <= high;
+            }
+        }
+        return count;
+    }
+
+    static uint64_t hashBytes(std::string_view bytes) // Word-at-a-time multiply-xor hash, only used to detect changed sources
+    {
+        uint64_t hash = 0x9E3779B97F4A7C15ull ^ bytes.size();
+        size_t i = 0;
+        for (; i + 8 <= bytes.size(); i += 8)
+        {
+            uint64_t word{};
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+            hash ^= hash >> 32;
+        }
+        uint64_t tail{ 0 };
+        std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+        hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+        return (hash ^ hash >> 29) | 1; // Never 0, which means "not hashed"
+    }
+protected:
+    struct FileHeader
+    {
+        char magic[8] = { 'D', 'M', 'C', 'A', 'C', 'H', 'E', '1' };
+        uint64_t rows = 0;
+        uint64_t columns = 0;
+        Stamp stamp;
+    };
+    struct ColumnHeader
+    {
+        Type type = Type::String;
+        uint64_t nameOffset = 0;
+        uint64_t nameLength = 0;
+        uint64_t dataOffset = 0;
+        uint64_t statsOffset = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    static uint64_t align(uint64_t offset) { return (offset + 7) & ~uint64_t{ 7 }; } // Typed columns are read in place
+
+    static bool parse(std::string_view text, int64_t& value)
+    {
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc{} && result.ptr == text.data() + text.size();
+    }
+    static bool parse(std::string_view text, double& value)
+    {
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc{} && result.ptr == text.data() + text.size();
+    }
+protected:
+    MappedFile file;
+    uint64_t rows = 0;
+    std::vector<Column> columns;
+};
+
+template<typename Function>
+void parallelFor(size_t count, Function&& function) // function(i) for every i in [0, count), each on its own thread
+{
+    std::vector<std::jthread> workers{};
+    for (size_t i = 1; i < count; i++)
+        workers.emplace_back([&function, i] { function(i); });
+    if (count > 0) function(0);
+}
 
 class DataMiner
 {
 public:
+    struct Pipeline // Streaming mode: a reader thread fills buffers while analyzeStream() consumes the previous one
+    {
+        size_t buffers = 2; // 2 is double buffering, 1 reads and analyzes in turn
+        size_t bufferBytes = 1 << 20;
+    };
+
+    struct PipelineStats
+    {
+        uint64_t bytes = 0;
+        size_t buffers = 0;
+        uint64_t carriedBytes = 0; // Partial records moved in front of the next buffer
+        std::chrono::steady_clock::duration elapsed{};
+        std::chrono::steady_clock::duration readBusy{};
+        std::chrono::steady_clock::duration readStalled{}; // Waiting for a free buffer
+        std::chrono::steady_clock::duration analyzeBusy{};
+        std::chrono::steady_clock::duration analyzeStalled{}; // Waiting for a filled buffer
+
+        double readUtilization() const { return elapsed.count() ? static_cast<double>(readBusy.count()) / elapsed.count() : 0.0; }
+        double analyzeUtilization() const { return elapsed.count() ? static_cast<double>(analyzeBusy.count()) / elapsed.count() : 0.0; }
+    };
+public:
+    bool mine(std::string_view filePath) // The template method
+    {
+        this->hook_Preprocessing();
+        if (!this->readData(filePath)) return false;
+        if (const auto pipeline = this->hook_StreamPipeline())
+        {
+            this->hook_BeginStream();
+            const bool streamed = this->runPipeline(filePath, *pipeline);
+            this->hook_EndStream();
+            return streamed;
+        }
+        const size_t chunks = this->hook_ParallelChunks();
+        const std::string_view data = this->hook_ChunkableData();
+        if (chunks <= 1 || data.empty())
+        {
+            this->analyze();
+            return true;
+        }
+        const std::vector<size_t> cuts = this->hook_SplitRecords(data, chunks);
+        this->hook_BeginChunks(chunks);
+        parallelFor(chunks, [&](size_t chunk) { this->analyzeChunk(chunk, data.substr(cuts[chunk], cuts[chunk + 1] - cuts[chunk])); });
+        this->hook_MergeChunks(chunks);
+        return true;
+    }
+public:
+    virtual ~DataMiner() = default;
+
+    void markIdentified() { this->identified = true; } // The file type is already known (e.g. sniffed), so readData() skips its extension check
+    void setOutput(std::ostream& output, std::ostream& errors) // Where results and errors go, the console by default
+    {
+        this->output = &output;
+        this->errors = &errors;
+    }
+
     virtual void hook_Preprocessing() {}; // Hooks are optional steps with empty bodies and do not have to be overriden.
 
-    virtual bool readData(std::string_view filePath) = 0; // Fixed step 1
-    virtual void analyze() = 0; // Fixed step 2
+    virtual bool readData(std::string_view filePath) = 0; // Fixed step 1
+    virtual void analyze() = 0; // Fixed step 2
+
+    virtual void optional_MinerVersion() const // Optional steps should have a default implementation
+    { *this->output << "My Data Miner 1.0.0\n"; } 
+
+    // Parallel analysis is opt-in: a miner returning more than one chunk gets analyzeChunk() on record-aligned chunks instead of analyze()
+    virtual size_t hook_ParallelChunks() const { return 1; }
+    virtual std::string_view hook_ChunkableData() const { return {}; }
+    virtual std::vector<size_t> hook_SplitRecords(std::string_view data, size_t chunks) const // chunks + 1 cuts, each just past a '\n'
+    {
+        std::vector<size_t> cuts(chunks + 1, data.size());
+        cuts[0] = 0;
+        for (size_t i = 1; i < chunks; i++)
+        {
+            const size_t newline = data.find('\n', std::max(data.size() * i / chunks, cuts[i - 1]));
+            cuts[i] = newline == std::string_view::npos ? data.size() : newline + 1;
+        }
+        return cuts;
+    }
+    virtual void hook_BeginChunks(size_t /*chunks*/) {} // Sizes per-chunk results before the chunks run
+    virtual void analyzeChunk(size_t /*chunk*/, std::string_view /*data*/) {} // Runs concurrently with the other chunks
+    virtual void hook_MergeChunks(size_t /*chunks*/) {} // Combines the per-chunk results, in chunk order
+
+    // Streaming is opt-in as well: a miner returning a Pipeline gets its file in buffers through analyzeStream() instead of analyze()
+    virtual std::optional<Pipeline> hook_StreamPipeline() const { return std::nullopt; }
+    virtual void hook_BeginStream() {}
+    virtual size_t analyzeStream(std::string_view bytes, bool /*last*/) { return bytes.size(); } // Returns the bytes used; the rest is carried over
+    virtual void hook_EndStream() {}
+
+    const PipelineStats& getPipelineStats() const { return this->pipelineStats; }
+protected:
+    bool runPipeline(std::string_view filePath, const Pipeline& options)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr size_t Headroom = 64 << 10; // Room to put a carried partial record right before the fresh bytes
+        std::FILE* file = std::fopen(std::string{ filePath }.c_str(), "rb");
+        if (!file) return false;
+        std::setvbuf(file, nullptr, _IONBF, 0); // The pipeline buffers are the only buffering
+
+        struct Filled
+        {
+            size_t buffer;
+            size_t size;
+            bool last;
+        };
+        std::vector<std::unique_ptr<char[]>> storage(std::max<size_t>(options.buffers, 1));
+        std::deque<size_t> free{};
+        for (size_t i = 0; i < storage.size(); i++)
+        {
+            storage[i] = std::make_unique<char[]>(Headroom + options.bufferBytes);
+            free.push_back(i);
+        }
+        std::deque<Filled> filled{};
+        std::mutex mutex{};
+        std::condition_variable changed{};
+        PipelineStats stats{};
+        const auto begin = Clock::now();
+
+        std::jthread reader{ [&]
+        {
+            for (bool last = false; !last;)
+            {
+                const auto waiting = Clock::now();
+                size_t buffer{};
+                {
+                    std::unique_lock lock{ mutex };
+                    changed.wait(lock, [&] { return !free.empty(); });
+                    buffer = free.front();
+                    free.pop_front();
+                }
+                const auto reading = Clock::now();
+                const size_t size = std::fread(storage[buffer].get() + Headroom, 1, options.bufferBytes, file);
+                last = size < options.bufferBytes;
+                const auto done = Clock::now();
+                {
+                    std::lock_guard lock{ mutex };
+                    stats.readStalled += reading - waiting;
+                    stats.readBusy += done - reading;
+                    filled.push_back(Filled{ buffer, size, last });
+                }
+                changed.notify_all();
+            }
+        } };
+
+        std::string carry{};
+        std::string oversized{}; // Carry plus buffer when the carry outgrows the headroom
+        for (bool last = false; !last;)
+        {
+            const auto waiting = Clock::now();
+            Filled current{};
+            {
+                std::unique_lock lock{ mutex };
+                changed.wait(lock, [&] { return !filled.empty(); });
+                current = filled.front();
+                filled.pop_front();
+            }
+            const auto analyzing = Clock::now();
+            last = current.last;
+            char* fresh = storage[current.buffer].get() + Headroom;
+            std::string_view bytes{ fresh, current.size };
+            if (carry.size() > Headroom)
+            {
+                oversized = carry;
+                oversized.append(fresh, current.size);
+                bytes = oversized;
+            }
+            else if (!carry.empty())
+            {
+                std::memcpy(fresh - carry.size(), carry.data(), carry.size());
+                bytes = std::string_view{ fresh - carry.size(), carry.size() + current.size };
+            }
+            const size_t used = std::min(this->analyzeStream(bytes, last), bytes.size());
+            carry.assign(bytes.substr(used));
+            const auto done = Clock::now();
+            {
+                std::lock_guard lock{ mutex };
+                free.push_back(current.buffer);
+                stats.analyzeStalled += analyzing - waiting;
+                stats.analyzeBusy += done - analyzing;
+                stats.bytes += current.size;
+                stats.buffers++;
+                stats.carriedBytes += carry.size();
+            }
+            changed.notify_all();
+        }
+        reader.join();
+        stats.elapsed = Clock::now() - begin;
+        const bool failed = std::ferror(file) != 0;
+        std::fclose(file);
+        this->pipelineStats = stats;
+        return !failed;
+    }
+protected:
+    PipelineStats pipelineStats;
+    bool identified = false;
+    std::ostream* output = &std::cout;
+    std::ostream* errors = &std::cerr;
+};
+
+class Inflater // zlib (RFC 1950) or raw deflate (RFC 1951) decoder for FlateDecode streams
+{
+public:
+    // Appends to output, keeping what was decoded before any error; output never grows past limit, reaching it is an error
+    static bool inflate(std::string_view input, std::string& output, size_t limit = SIZE_MAX)
+    {
+        Inflater inflater{ input, limit };
+        if (input.size() >= 2 && (input[0] & 0x0F) == 8 && (static_cast<uint8_t>(input[0]) << 8 | static_cast<uint8_t>(input[1])) % 31 == 0)
+        {
+            if (input[1] & 0x20) return false; // Preset dictionaries never occur in PDF streams
+            inflater.position = 2;
+        }
+        for (bool last = false; !last;)
+        {
+            last = inflater.bits(1) != 0;
+            const uint32_t type = inflater.bits(2);
+            const bool decoded = type == 0 ? inflater.stored(output)
+                : type == 1 ? inflater.codes(output, fixed().first, fixed().second)
+                : type == 2 ? inflater.dynamic(output) : false;
+            if (!decoded || inflater.truncated) return false;
+        }
+        return true;
+    }
+protected:
+    static constexpr int FastBits = 9; // Codes up to this length decode with one table lookup
+
+    struct Huffman // Canonical code: how many codes of each length, and the symbols in code order
+    {
+        std::array<uint16_t, 16> count{};
+        std::vector<uint16_t> symbol;
+        std::array<uint16_t, 1 << FastBits> fast{}; // Next FastBits input bits -> symbol | length << 9, 0 when the code is longer
+    };
+
+    Inflater(std::string_view input, size_t limit) :input{ input }, limit{ limit } {}
+
+    static bool build(Huffman& huffman, const uint8_t* lengths, size_t symbols) // False for an over-subscribed code
+    {
+        huffman.count.fill(0);
+        huffman.fast.fill(0);
+        huffman.symbol.assign(symbols, 0);
+        for (size_t i = 0; i < symbols; i++) huffman.count[lengths[i]]++;
+        huffman.count[0] = 0;
+        int left = 1;
+        for (size_t length = 1; length < 16; length++)
+        {
+            left = (left << 1) - huffman.count[length];
+            if (left < 0) return false;
+        }
+        std::array<uint16_t, 16> offsets{};
+        std::array<uint32_t, 16> next{};
+        for (size_t length = 1; length < 15; length++) offsets[length + 1] = offsets[length] + huffman.count[length];
+        for (size_t length = 1, code = 0; length < 16; length++)
+        {
+            code = (code + huffman.count[length - 1]) << 1;
+            next[length] = static_cast<uint32_t>(code);
+        }
+        for (size_t symbol = 0; symbol < symbols; symbol++)
+        {
+            const uint8_t length = lengths[symbol];
+            if (length == 0) continue;
+            huffman.symbol[offsets[length]++] = static_cast<uint16_t>(symbol);
+            const uint32_t code = next[length]++;
+            if (length > FastBits) continue;
+            uint32_t reversed = 0; // Deflate sends Huffman codes most significant bit first
+            for (uint8_t bit = 0; bit < length; bit++) reversed |= (code >> bit & 1) << (length - 1 - bit);
+            for (uint32_t index = reversed; index < huffman.fast.size(); index += 1u << length)
+                huffman.fast[index] = static_cast<uint16_t>(symbol | length << 9);
+        }
+        return true;
+    }
+    static const std::pair<Huffman, Huffman>& fixed()
+    {
+        static const std::pair<Huffman, Huffman> tables = []
+        {
+            std::array<uint8_t, 288> literals{};
+            std::fill(literals.begin(), literals.begin() + 144, uint8_t{ 8 });
+            std::fill(literals.begin() + 144, literals.begin() + 256, uint8_t{ 9 });
+            std::fill(literals.begin() + 256, literals.begin() + 280, uint8_t{ 7 });
+            std::fill(literals.begin() + 280, literals.end(), uint8_t{ 8 });
+            std::array<uint8_t, 30> distances{};
+            distances.fill(5);
+            std::pair<Huffman, Huffman> built{};
+            build(built.first, literals.data(), literals.size());
+            build(built.second, distances.data(), distances.size());
+            return built;
+        }();
+        return tables;
+    }
+
+    void fill()
+    {
+        while (this->available <= 24 && this->position < this->input.size())
+        {
+            this->buffer |= static_cast<uint32_t>(static_cast<uint8_t>(this->input[this->position++])) << this->available;
+            this->available += 8;
+        }
+    }
+    uint32_t bits(int count)
+    {
+        if (this->available < count) this->fill();
+        if (this->available < count)
+        {
+            this->truncated = true;
+            return 0;
+        }
+        const uint32_t value = this->buffer & ((uint32_t{ 1 } << count) - 1);
+        this->buffer >>= count;
+        this->available -= count;
+        return value;
+    }
+    int decode(const Huffman& huffman)
+    {
+        this->fill();
+        if (this->available >= FastBits)
+            if (const uint16_t entry = huffman.fast[this->buffer & ((1u << FastBits) - 1)])
+            {
+                this->bits(entry >> 9);
+                return entry & 0x1FF;
+            }
+        for (int length = 1, code = 0, first = 0, index = 0; length < 16; length++) // Slow path: one bit at a time
+        {
+            code |= static_cast<int>(this->bits(1));
+            const int count = huffman.count[length];
+            if (code - first < count) return huffman.symbol[index + code - first];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+            if (this->truncated) break;
+        }
+        return -1;
+    }
+
+    bool stored(std::string& output)
+    {
+        this->bits(this->available % 8);
+        const uint32_t length = this->bits(16);
+        if ((~this->bits(16) & 0xFFFF) != length) return false;
+        if (output.size() + length > this->limit) return false;
+        size_t remaining = length;
+        for (; remaining > 0 && this->available >= 8; remaining--) output.push_back(static_cast<char>(this->bits(8))); // Bytes already in the bit buffer
+        if (this->input.size() - this->position < remaining)
+        {
+            this->truncated = true;
+            return false;
+        }
+        output.append(this->input.substr(this->position, remaining));
+        this->position += remaining;
+        return true;
+    }
+    bool codes(std::string& output, const Huffman& literalCode, const Huffman& distanceCode)
+    {
+        static constexpr uint16_t LengthBase[29]{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static constexpr uint8_t LengthExtra[29]{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static constexpr uint16_t DistanceBase[30]{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+            4097, 6145, 8193, 12289, 16385, 24577 };
+        static constexpr uint8_t DistanceExtra[30]{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+        for (;;)
+        {
+            int symbol = this->decode(literalCode);
+            if (symbol < 0 || this->truncated) return false;
+            if (symbol < 256)
+            {
+                if (output.size() >= this->limit) return false;
+                output.push_back(static_cast<char>(symbol));
+                continue;
+            }
+            if (symbol == 256) return true;
+            symbol -= 257;
+            if (symbol >= 29) return false;
+            const size_t length = LengthBase[symbol] + this->bits(LengthExtra[symbol]);
+            const int code = this->decode(distanceCode);
+            if (code < 0 || code >= 30) return false;
+            const size_t distance = DistanceBase[code] + this->bits(DistanceExtra[code]);
+            if (distance > output.size() || output.size() + length > this->limit || this->truncated) return false;
+            const size_t at = output.size();
+            output.resize(at + length);
+            char* bytes = output.data();
+            for (size_t i = 0; i < length; i++) bytes[at + i] = bytes[at - distance + i]; // Byte by byte: the copy may overlap itself
+        }
+    }
+    bool dynamic(std::string& output)
+    {
+        static constexpr uint8_t Order[19]{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+        const size_t literals = this->bits(5) + 257, distances = this->bits(5) + 1, lengthCodes = this->bits(4) + 4;
+        if (literals > 286 || distances > 30) return false;
+        std::array<uint8_t, 19> lengthLengths{};
+        for (size_t i = 0; i < lengthCodes; i++) lengthLengths[Order[i]] = static_cast<uint8_t>(this->bits(3));
+        Huffman lengthCode{};
+        if (!build(lengthCode, lengthLengths.data(), lengthLengths.size())) return false;
+
+        std::array<uint8_t, 286 + 30> lengths{};
+        for (size_t index = 0; index < literals + distances;)
+        {
+            const int symbol = this->decode(lengthCode);
+            if (symbol < 0 || this->truncated) return false;
+            if (symbol < 16)
+            {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            uint8_t repeated = 0;
+            size_t times = 0;
+            if (symbol == 16)
+            {
+                if (index == 0) return false;
+                repeated = lengths[index - 1];
+                times = 3 + this->bits(2);
+            }
+            else times = symbol == 17 ? 3 + this->bits(3) : 11 + this->bits(7);
+            if (index + times > literals + distances) return false;
+            std::fill_n(lengths.begin() + index, times, repeated);
+            index += times;
+        }
+        if (lengths[256] == 0) return false; // No end-of-block code
+        Huffman literalCode{}, distanceCode{};
+        if (!build(literalCode, lengths.data(), literals) || !build(distanceCode, lengths.data() + literals, distances)) return false;
+        return this->codes(output, literalCode, distanceCode);
+    }
+protected:
+    std::string_view input;
+    size_t limit; // Of the output, so a small stream cannot expand without bound
+    size_t position = 0;
+    uint32_t buffer = 0;
+    int available = 0; // Bits in buffer
+    bool truncated = false;
+};
+
+struct PDFObject // One value of the PDF object model; a stream is its dictionary plus where its data starts in the file
+{
+    struct Name { std::string value; };
+    struct Keyword { std::string value; }; // Bare words: content stream operators, obj, stream, trailer
+    struct Reference
+    {
+        uint32_t number = 0;
+        uint32_t generation = 0;
+    };
+    using Array = std::vector<PDFObject>;
+    using Dictionary = std::vector<std::pair<std::string, PDFObject>>; // Dictionaries are small, a linear scan beats hashing
+
+    std::variant<std::monostate, bool, double, std::string, Name, Keyword, Reference, Array, Dictionary> value;
+    int64_t streamOffset = -1;
+
+    template<typename T>
+    const T* as() const { return std::get_if<T>(&this->value); }
+    const PDFObject* get(std::string_view key) const
+    {
+        if (const auto dictionary = this->as<Dictionary>())
+            for (const auto& [name, value] : *dictionary)
+                if (name == key) return &value;
+        return nullptr;
+    }
+    double number(double fallback = 0) const { const auto value = this->as<double>(); return value ? *value : fallback; }
+    uint64_t unsignedNumber(uint64_t fallback = 0) const // For counts and offsets: negative and NaN become 0, huge values stop at 2^53
+    {
+        const double value = this->number(static_cast<double>(fallback));
+        return value > 0 ? static_cast<uint64_t>(std::min(value, 9007199254740992.0)) : 0;
+    }
+    bool isName(std::string_view name) const { const auto value = this->as<Name>(); return value && value->value == name; }
+    bool isKeyword(std::string_view word) const { const auto value = this->as<Keyword>(); return value && value->value == word; }
+};
+
+class PDFParser // Objects and content stream tokens out of bytes already in memory
+{
+public:
+    explicit PDFParser(std::string_view bytes, size_t position = 0) :bytes{ bytes }, position{ position } {}
+
+    PDFObject parseObject(int depth = 0) // "n g R" comes back as a Reference, anything unquoted that is no value as a Keyword
+    {
+        this->skipSpace();
+        if (this->position >= this->bytes.size())
+        {
+            this->ranOut = true;
+            return {};
+        }
+        const char c = this->bytes[this->position];
+        if (depth > MaxDepth)
+        {
+            this->position++;
+            return {};
+        }
+        if (c == '/') return this->name();
+        if (c == '(') return this->literal();
+        if (c == '<' && this->position + 1 < this->bytes.size() && this->bytes[this->position + 1] == '<') return this->dictionary(depth);
+        if (c == '<') return this->hex();
+        if (c == '[') return this->array(depth);
+        if (c == '+' || c == '-' || c == '.' || (c >= '0' && c <= '9')) return this->numberOrReference();
+        if (isDelimiter(c)) // Stray ) > ] or PostScript braces
+        {
+            this->position++;
+            return PDFObject{ PDFObject::Keyword{ std::string(1, c) } };
+        }
+        const std::string_view word = this->word();
+        if (word == "true" || word == "false") return PDFObject{ word == "true" };
+        if (word == "null") return {};
+        return PDFObject{ PDFObject::Keyword{ std::string{ word } } };
+    }
+
+    bool atEnd() { this->skipSpace(); return this->position >= this->bytes.size(); }
+    bool exhausted() const { return this->ranOut; } // An object ran past the end of the bytes, so a longer read may complete it
+    size_t getPosition() const { return this->position; }
+    void setPosition(size_t position) { this->position = position; }
+    std::string_view getBytes() const { return this->bytes; }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0'; }
+    static bool isDelimiter(char c) { return c != '\0' && std::strchr("()<>[]{}/%", c) != nullptr; }
+protected:
+    static constexpr int MaxDepth = 256; // Nesting guard against hostile files
+
+    void skipSpace()
+    {
+        while (this->position < this->bytes.size())
+        {
+            const char c = this->bytes[this->position];
+            if (isSpace(c)) this->position++;
+            else if (c == '%')
+                while (this->position < this->bytes.size() && this->bytes[this->position] != '\n' && this->bytes[this->position] != '\r') this->position++;
+            else break;
+        }
+    }
+    std::string_view word()
+    {
+        const size_t begin = this->position;
+        while (this->position < this->bytes.size() && !isSpace(this->bytes[this->position]) && !isDelimiter(this->bytes[this->position])) this->position++;
+        return this->bytes.substr(begin, this->position - begin);
+    }
+    static int hexValue(char c) { return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1; }
+
+    PDFObject name()
+    {
+        this->position++;
+        const std::string_view raw = this->word();
+        std::string decoded{};
+        for (size_t i = 0; i < raw.size(); i++)
+            if (raw[i] == '#' && i + 2 < raw.size() && hexValue(raw[i + 1]) >= 0 && hexValue(raw[i + 2]) >= 0)
+            {
+                decoded.push_back(static_cast<char>(hexValue(raw[i + 1]) << 4 | hexValue(raw[i + 2])));
+                i += 2;
+            }
+            else decoded.push_back(raw[i]);
+        return PDFObject{ PDFObject::Name{ std::move(decoded) } };
+    }
+    PDFObject literal()
+    {
+        std::string text{};
+        this->position++;
+        for (int depth = 1; this->position < this->bytes.size();)
+        {
+            const char c = this->bytes[this->position++];
+            if (c == ')' && --depth == 0) return PDFObject{ std::move(text) };
+            if (c == '(') depth++;
+            if (c != '\\')
+            {
+                text.push_back(c);
+                continue;
+            }
+            if (this->position >= this->bytes.size()) break;
+            const char escaped = this->bytes[this->position++];
+            switch (escaped)
+            {
+            case 'n': text.push_back('\n'); break;
+            case 'r': text.push_back('\r'); break;
+            case 't': text.push_back('\t'); break;
+            case 'b': text.push_back('\b'); break;
+            case 'f': text.push_back('\f'); break;
+            case '\r': // Line continuation
+                if (this->position < this->bytes.size() && this->bytes[this->position] == '\n') this->position++;
+                break;
+            case '\n': break;
+            default:
+                if (escaped >= '0' && escaped <= '7')
+                {
+                    int value = escaped - '0';
+                    for (int digits = 1; digits < 3 && this->position < this->bytes.size() && this->bytes[this->position] >= '0' && this->bytes[this->position] <= '7'; digits++)
+                        value = value * 8 + (this->bytes[this->position++] - '0');
+                    text.push_back(static_cast<char>(value));
+                }
+                else text.push_back(escaped); // \( \) \\ and unknown escapes
+            }
+        }
+        this->ranOut = true;
+        return PDFObject{ std::move(text) };
+    }
+    PDFObject hex()
+    {
+        std::string bytes{};
+        int high = -1;
+        for (this->position++; this->position < this->bytes.size();)
+        {
+            const char c = this->bytes[this->position++];
+            if (c == '>')
+            {
+                if (high >= 0) bytes.push_back(static_cast<char>(high << 4)); // An odd final digit is followed by an implied 0
+                return PDFObject{ std::move(bytes) };
+            }
+            const int value = hexValue(c);
+            if (value < 0) continue;
+            if (high < 0) high = value;
+            else
+            {
+                bytes.push_back(static_cast<char>(high << 4 | value));
+                high = -1;
+            }
+        }
+        this->ranOut = true;
+        return PDFObject{ std::move(bytes) };
+    }
+    PDFObject dictionary(int depth)
+    {
+        PDFObject::Dictionary entries{};
+        for (this->position += 2;;)
+        {
+            this->skipSpace();
+            if (this->position >= this->bytes.size())
+            {
+                this->ranOut = true;
+                break;
+            }
+            if (this->bytes[this->position] == '>')
+            {
+                this->position += this->position + 1 < this->bytes.size() && this->bytes[this->position + 1] == '>' ? 2 : 1;
+                break;
+            }
+            const PDFObject key = this->parseObject(depth + 1);
+            const auto name = key.as<PDFObject::Name>();
+            if (!name) continue; // Malformed: skip the token
+            entries.emplace_back(name->value, this->parseObject(depth + 1));
+        }
+        return PDFObject{ std::move(entries) };
+    }
+    PDFObject array(int depth)
+    {
+        PDFObject::Array items{};
+        for (this->position++;;)
+        {
+            this->skipSpace();
+            if (this->position >= this->bytes.size())
+            {
+                this->ranOut = true;
+                break;
+            }
+            if (this->bytes[this->position] == ']')
+            {
+                this->position++;
+                break;
+            }
+            items.push_back(this->parseObject(depth + 1));
+        }
+        return PDFObject{ std::move(items) };
+    }
+    PDFObject numberOrReference()
+    {
+        const size_t begin = this->position;
+        for (char c; this->position < this->bytes.size() && ((c = this->bytes[this->position]) == '+' || c == '-' || c == '.' || (c >= '0' && c <= '9'));) this->position++;
+        std::string_view text = this->bytes.substr(begin, this->position - begin);
+        const bool integer = text.find_first_of("+-.") == std::string_view::npos;
+        if (text.starts_with('+')) text.remove_prefix(1);
+        double value = 0;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        if (integer && value <= 0xFFFFFFFF) // "n g R": look ahead for the generation and the R
+        {
+            const size_t after = this->position;
+            this->skipSpace();
+            const size_t generation = this->position;
+            while (this->position < this->bytes.size() && this->bytes[this->position] >= '0' && this->bytes[this->position] <= '9') this->position++;
+            if (this->position > generation)
+            {
+                const size_t digits = this->position;
+                this->skipSpace();
+                if (this->position < this->bytes.size() && this->bytes[this->position] == 'R'
+                    && (this->position + 1 == this->bytes.size() || isSpace(this->bytes[this->position + 1]) || isDelimiter(this->bytes[this->position + 1])))
+                {
+                    this->position++;
+                    uint32_t number = 0;
+                    std::from_chars(this->bytes.data() + generation, this->bytes.data() + digits, number);
+                    return PDFObject{ PDFObject::Reference{ static_cast<uint32_t>(value), number } };
+                }
+            }
+            this->position = after;
+        }
+        return PDFObject{ value };
+    }
+protected:
+    std::string_view bytes;
+    size_t position = 0;
+    bool ranOut = false;
+};
+
+class PDFDocument // Reads a PDF through its cross-reference data: only what the current page needs is read and kept
+{
+public:
+    bool open(const std::filesystem::path& path, std::string& error)
+    {
+        *this = PDFDocument{};
+        this->file.reset(std::fopen(path.string().c_str(), "rb"));
+        std::error_code code{};
+        this->fileSize = std::filesystem::file_size(path, code);
+        if (!this->file || code)
+        {
+            error = "cannot open the file";
+            return false;
+        }
+        if (this->readAt(0, 1024).find("%PDF-") == std::string::npos)
+        {
+            error = "no %PDF- header";
+            return false;
+        }
+        const std::string tail = this->readAt(this->fileSize > 1024 ? this->fileSize - 1024 : 0, 1024);
+        const size_t startxref = tail.rfind("startxref");
+        if (startxref == std::string::npos)
+        {
+            error = "no startxref";
+            return false;
+        }
+        const PDFObject offset = PDFParser{ tail, startxref + 9 }.parseObject();
+        if (!(offset.number(-1) >= 0) || !this->loadXref(offset.unsignedNumber()))
+        {
+            error = "broken cross-reference data";
+            return false;
+        }
+        if (this->trailer.get("Encrypt"))
+        {
+            error = "encrypted documents are not supported";
+            return false;
+        }
+        const PDFObject catalog = this->resolve(this->trailer.get("Root"));
+        const PDFObject pages = this->resolve(catalog.get("Pages"));
+        if (!pages.get("Kids"))
+        {
+            error = "no page tree";
+            return false;
+        }
+        this->pageCount = static_cast<size_t>(this->resolve(pages.get("Count")).unsignedNumber());
+        if (const auto reference = catalog.get("Pages")->as<PDFObject::Reference>()) this->visited.insert(reference->number);
+        this->pushFrame(pages, {});
+        return true;
+    }
+
+    bool nextPage(std::string& text) // Text of the next page in content stream order; false past the last page
+    {
+        text.clear();
+        if (this->fonts.size() > FontLimit) this->fonts.clear(); // Only between pages: extraction holds pointers into it
+        while (!this->pages.empty())
+        {
+            Frame& frame = this->pages.back();
+            if (frame.next >= frame.kids.size())
+            {
+                this->pages.pop_back();
+                continue;
+            }
+            const PDFObject& kid = frame.kids[frame.next++];
+            const PDFObject node = this->resolve(&kid);
+            if (node.get("Kids"))
+            {
+                const auto reference = kid.as<PDFObject::Reference>();
+                if (reference && !this->visited.insert(reference->number).second) continue; // Page tree cycle
+                if (this->pages.size() < MaxTreeDepth) this->pushFrame(node, PDFObject{ frame.resources });
+                continue;
+            }
+            const PDFObject* own = node.get("Resources");
+            const PDFObject resources = own ? this->resolve(own) : frame.resources;
+            const PDFObject contents = this->resolve(node.get("Contents"));
+            std::string content{}, part{};
+            if (const auto streams = contents.as<PDFObject::Array>())
+                for (const auto& stream : *streams) // A page may split its content anywhere between tokens
+                {
+                    if (this->decodeStream(this->resolve(&stream), part)) content += part;
+                    content.push_back('\n');
+                }
+            else this->decodeStream(contents, content);
+            this->peakBuffer = std::max<uint64_t>(this->peakBuffer, content.size());
+            this->extractText(content, resources, text);
+            return true;
+        }
+        return false;
+    }
+
+    size_t getPageCount() const { return this->pageCount; } // As the page tree claims
+    uint64_t getPeakBufferBytes() const { return this->peakBuffer; } // Largest decoded page content held at once
+protected:
+    static constexpr size_t ObjectCacheLimit = 1024;
+    static constexpr size_t ObjectStreamCacheLimit = 8;
+    static constexpr size_t FontLimit = 256;
+    static constexpr size_t MaxTreeDepth = 64;
+    static constexpr uint32_t MaxObjects = 1 << 24;
+    static constexpr size_t MaxDecodedBytes = 64 << 20; // Per stream after FlateDecode, deflate alone expands up to ~1000:1
+    static constexpr size_t MaxReadWindow = 64 << 20; // Largest read for one xref table or object dictionary
+
+    struct XrefEntry
+    {
+        uint8_t type = 0; // 0 free, 1 at offset in the file, 2 number index inside object stream offset
+        bool known = false; // Set by the newest section mentioning it
+        uint64_t offset = 0;
+        uint32_t index = 0;
+    };
+    struct ObjectStream
+    {
+        std::string data;
+        std::vector<size_t> offsets;
+    };
+    struct Frame // A page tree node being walked, with the resources its pages inherit
+    {
+        PDFObject::Array kids;
+        size_t next = 0;
+        PDFObject resources;
+    };
+    struct Font
+    {
+        std::unordered_map<uint32_t, std::string> unicode; // ToUnicode CMap: character code -> UTF-8
+        size_t codeBytes = 1;
+    };
+
+    void pushFrame(const PDFObject& node, PDFObject inherited)
+    {
+        Frame frame{};
+        const PDFObject kids = this->resolve(node.get("Kids"));
+        if (const auto items = kids.as<PDFObject::Array>()) frame.kids = *items;
+        const PDFObject* own = node.get("Resources");
+        frame.resources = own ? this->resolve(own) : std::move(inherited);
+        this->pages.push_back(std::move(frame));
+    }
+
+    std::string readAt(uint64_t offset, size_t length)
+    {
+        std::string bytes(offset < this->fileSize ? static_cast<size_t>(std::min<uint64_t>(length, this->fileSize - offset)) : 0, '\0');
+#if defined(_WIN32)
+        ::_fseeki64(this->file.get(), static_cast<int64_t>(offset), SEEK_SET);
+#else
+        ::fseeko(this->file.get(), static_cast<off_t>(offset), SEEK_SET);
+#endif
+        bytes.resize(std::fread(bytes.data(), 1, bytes.size(), this->file.get()));
+        return bytes;
+    }
 
-    virtual void optional_MinerVersion() const // Optional steps should have a default implementation
-    { std::cout << "My Data Miner 1.0.0\n"; } 
+    void record(uint64_t number, const XrefEntry& entry)
+    {
+        if (number >= MaxObjects) return;
+        if (number >= this->xref.size()) this->xref.resize(static_cast<size_t>(number) + 1);
+        if (this->xref[number].known) return; // Sections are read newest first
+        this->xref[number] = entry;
+        this->xref[number].known = true;
+    }
+    bool loadXref(uint64_t offset) // Follows /Prev from the newest section to the oldest
+    {
+        std::vector<uint64_t> seen{};
+        for (std::optional<uint64_t> next = offset; next && *next < this->fileSize && std::ranges::find(seen, *next) == seen.end();)
+        {
+            seen.push_back(*next);
+            const PDFObject section = this->readAt(*next, 4).starts_with("xref") ? this->readXrefTable(*next) : this->readXrefStream(*next);
+            if (!section.as<PDFObject::Dictionary>()) break;
+            if (seen.size() == 1) this->trailer = section;
+            if (const auto hybrid = section.get("XRefStm")) this->readXrefStream(hybrid->unsignedNumber()); // Compressed objects of hybrid files
+            const auto previous = section.get("Prev");
+            next = previous && previous->number(-1) >= 0 ? std::optional<uint64_t>{ previous->unsignedNumber() } : std::nullopt;
+        }
+        return this->trailer.as<PDFObject::Dictionary>() != nullptr;
+    }
+    PDFObject readXrefTable(uint64_t offset) // Classic "xref" subsections; returns the trailer dictionary
+    {
+        for (size_t window = 64 << 10;; window = std::min(window * 4, MaxReadWindow))
+        {
+            const std::string bytes = this->readAt(offset, window);
+            const bool whole = bytes.size() < window;
+            PDFParser parser{ bytes, 4 };
+            std::vector<std::pair<uint64_t, XrefEntry>> entries{};
+            while (!parser.exhausted())
+            {
+                const PDFObject token = parser.parseObject();
+                if (token.isKeyword("trailer"))
+                {
+                    PDFObject trailer = parser.parseObject();
+                    if (parser.exhausted()) break;
+                    for (const auto& [number, entry] : entries) this->record(number, entry);
+                    return trailer;
+                }
+                const double first = token.number(-1), count = parser.parseObject().number(-1);
+                if (first < 0 || count < 0 || first + count > MaxObjects) return {};
+                for (uint32_t i = 0; i < count && !parser.exhausted(); i++)
+                {
+                    const uint64_t at = parser.parseObject().unsignedNumber();
+                    parser.parseObject(); // Generation
+                    const bool used = parser.parseObject().isKeyword("n");
+                    entries.emplace_back(static_cast<uint64_t>(first) + i, XrefEntry{ static_cast<uint8_t>(used ? 1 : 0), false, at, 0 });
+                }
+            }
+            if (whole || window == MaxReadWindow) return {}; // No trailer
+        }
+    }
+    PDFObject readXrefStream(uint64_t offset) // PDF 1.5 cross-reference stream; its dictionary doubles as the trailer
+    {
+        PDFObject stream = this->readObjectAt(offset);
+        std::string data{};
+        if (!stream.get("Type") || !stream.get("Type")->isName("XRef") || !this->decodeStream(stream, data)) return {};
+        const auto widths = stream.get("W") ? stream.get("W")->as<PDFObject::Array>() : nullptr;
+        if (!widths || widths->size() < 3) return {};
+        const size_t width[3]{ static_cast<size_t>((*widths)[0].unsignedNumber()), static_cast<size_t>((*widths)[1].unsignedNumber()), static_cast<size_t>((*widths)[2].unsignedNumber()) };
+        const size_t row = width[0] + width[1] + width[2];
+        if (row == 0 || width[0] > 8 || width[1] > 8 || width[2] > 8) return {};
+        PDFObject::Array index{ PDFObject{ 0.0 }, PDFObject{ stream.get("Size") ? stream.get("Size")->number() : 0.0 } };
+        if (const auto given = stream.get("Index") ? stream.get("Index")->as<PDFObject::Array>() : nullptr) index = *given;
+
+        size_t at = 0;
+        const auto field = [&](size_t bytes, uint64_t fallback)
+        {
+            if (bytes == 0) return fallback;
+            uint64_t value = 0;
+            for (size_t i = 0; i < bytes; i++) value = value << 8 | static_cast<uint8_t>(data[at++]);
+            return value;
+        };
+        for (size_t range = 0; range + 1 < index.size(); range += 2)
+        {
+            const uint64_t first = index[range].unsignedNumber(), count = index[range + 1].unsignedNumber();
+            for (uint64_t i = 0; i < count && at + row <= data.size(); i++)
+            {
+                const uint64_t type = field(width[0], 1), second = field(width[1], 0), third = field(width[2], 0);
+                this->record(first + i, XrefEntry{ static_cast<uint8_t>(type), false, second, static_cast<uint32_t>(third) });
+            }
+        }
+        stream.streamOffset = -1;
+        return stream;
+    }
+
+    PDFObject readObjectAt(uint64_t offset) // "n g obj ... endobj", growing the read until the object is complete
+    {
+        for (size_t window = 4096;; window = std::min(window * 8, MaxReadWindow))
+        {
+            const std::string bytes = this->readAt(offset, window);
+            const bool whole = bytes.size() < window;
+            PDFParser parser{ bytes };
+            parser.parseObject(); // Number and generation
+            parser.parseObject();
+            if (!parser.parseObject().isKeyword("obj")) return {};
+            PDFObject object = parser.parseObject();
+            const PDFObject next = parser.parseObject();
+            if (!whole && (parser.exhausted() || parser.getPosition() + 2 >= bytes.size()))
+            {
+                if (window == MaxReadWindow) return {};
+                continue;
+            }
+            if (next.isKeyword("stream")) // Data starts after one end of line
+            {
+                size_t data = parser.getPosition();
+                if (data < bytes.size() && bytes[data] == '\r') data++;
+                if (data < bytes.size() && bytes[data] == '\n') data++;
+                object.streamOffset = static_cast<int64_t>(offset + data);
+            }
+            return object;
+        }
+    }
+    PDFObject readObject(uint32_t number)
+    {
+        if (number >= this->xref.size()) return {};
+        if (const auto cached = this->objects.find(number); cached != this->objects.end()) return cached->second;
+        const XrefEntry entry = this->xref[number];
+        PDFObject object{};
+        if (entry.type == 1) object = this->readObjectAt(entry.offset);
+        else if (entry.type == 2) object = this->readFromObjectStream(static_cast<uint32_t>(entry.offset), entry.index);
+        if (this->objects.size() >= ObjectCacheLimit) this->objects.clear();
+        this->objects.emplace(number, object);
+        return object;
+    }
+    PDFObject readFromObjectStream(uint32_t streamNumber, uint32_t index)
+    {
+        auto found = this->objectStreams.find(streamNumber);
+        if (found == this->objectStreams.end())
+        {
+            if (streamNumber >= this->xref.size() || this->xref[streamNumber].type != 1) return {}; // Object streams cannot nest
+            const PDFObject stream = this->readObjectAt(this->xref[streamNumber].offset);
+            ObjectStream decoded{};
+            if (!this->decodeStream(stream, decoded.data)) return {};
+            const size_t count = static_cast<size_t>(stream.get("N") ? stream.get("N")->unsignedNumber() : 0);
+            const size_t first = static_cast<size_t>(stream.get("First") ? stream.get("First")->unsignedNumber() : 0);
+            PDFParser header{ std::string_view{ decoded.data }.substr(0, first) };
+            for (size_t i = 0; i < count && !header.atEnd(); i++)
+            {
+                header.parseObject(); // Object number
+                decoded.offsets.push_back(first + static_cast<size_t>(header.parseObject().unsignedNumber()));
+            }
+            if (this->objectStreams.size() >= ObjectStreamCacheLimit) this->objectStreams.clear();
+            found = this->objectStreams.emplace(streamNumber, std::move(decoded)).first;
+        }
+        const ObjectStream& stream = found->second;
+        if (index >= stream.offsets.size() || stream.offsets[index] >= stream.data.size()) return {};
+        return PDFParser{ stream.data, stream.offsets[index] }.parseObject();
+    }
+    PDFObject resolve(const PDFObject* object)
+    {
+        if (!object) return {};
+        if (const auto reference = object->as<PDFObject::Reference>()) return this->readObject(reference->number);
+        return *object;
+    }
+
+    uint64_t findEndstream(uint64_t offset) // For a missing or wrong /Length
+    {
+        constexpr size_t Chunk = 64 << 10;
+        for (uint64_t at = offset; at < this->fileSize; at += Chunk - 16)
+        {
+            const std::string bytes = this->readAt(at, Chunk);
+            if (const size_t found = bytes.find("endstream"); found != std::string::npos) return at + found - offset;
+            if (bytes.size() < Chunk) break;
+        }
+        return this->fileSize - std::min(offset, this->fileSize);
+    }
+    bool decodeStream(const PDFObject& stream, std::string& decoded) // Runs the /Filter chain; false for filters meant for images
+    {
+        decoded.clear();
+        if (stream.streamOffset < 0) return false;
+        const uint64_t offset = static_cast<uint64_t>(stream.streamOffset);
+        const PDFObject length = this->resolve(stream.get("Length"));
+        const uint64_t available = this->fileSize - std::min(offset, this->fileSize);
+        const uint64_t size = length.number(-1) >= 0 && length.unsignedNumber() <= available ? length.unsignedNumber() : this->findEndstream(offset);
+        std::string data = this->readAt(offset, static_cast<size_t>(size));
+
+        const PDFObject filter = this->resolve(stream.get("Filter")), parameters = this->resolve(stream.get("DecodeParms"));
+        PDFObject::Array filters{}, filterParameters{};
+        if (const auto names = filter.as<PDFObject::Array>()) filters = *names;
+        else if (filter.as<PDFObject::Name>()) filters.push_back(filter);
+        if (const auto each = parameters.as<PDFObject::Array>()) filterParameters = *each;
+        else filterParameters.assign(filters.size(), parameters);
+        for (size_t i = 0; i < filters.size(); i++)
+        {
+            const PDFObject& name = filters[i];
+            const PDFObject parameter = i < filterParameters.size() ? this->resolve(&filterParameters[i]) : PDFObject{};
+            std::string output{};
+            if (name.isName("FlateDecode") || name.isName("Fl"))
+            {
+                if (!Inflater::inflate(data, output, MaxDecodedBytes) && output.empty()) return false; // A damaged or oversized tail still yields the text before it
+                const double predictor = parameter.get("Predictor") ? parameter.get("Predictor")->number() : 1;
+                if (predictor >= 10 && !unpredict(output, static_cast<size_t>(parameter.get("Columns") ? parameter.get("Columns")->unsignedNumber() : 1),
+                    static_cast<size_t>(parameter.get("Colors") ? parameter.get("Colors")->unsignedNumber() : 1),
+                    static_cast<size_t>(parameter.get("BitsPerComponent") ? parameter.get("BitsPerComponent")->unsignedNumber() : 8))) return false;
+            }
+            else if (name.isName("ASCIIHexDecode") || name.isName("AHx"))
+            {
+                const std::string wrapped = "<" + data; // The data ends with its own '>'
+                if (const PDFObject bytes = PDFParser{ wrapped }.parseObject(); bytes.as<std::string>()) output = *bytes.as<std::string>();
+            }
+            else if (name.isName("ASCII85Decode") || name.isName("A85")) output = decodeASCII85(data);
+            else return false;
+            data = std::move(output);
+        }
+        decoded = std::move(data);
+        return true;
+    }
+    static bool unpredict(std::string& data, size_t columns, size_t colors, size_t bitsPerComponent) // PNG row filters
+    {
+        if (colors > 32 || bitsPerComponent > 16 || columns / 8 > data.size()) return false; // Out of range, or a row longer than the data
+        const size_t pixelBytes = std::max<size_t>(1, colors * bitsPerComponent / 8);
+        const size_t rowBytes = (columns * colors * bitsPerComponent + 7) / 8;
+        if (rowBytes == 0) return false;
+        std::string decoded{};
+        decoded.reserve(data.size());
+        std::vector<uint8_t> previous(rowBytes, 0), row(rowBytes, 0);
+        for (size_t at = 0; at + 1 + rowBytes <= data.size(); at += 1 + rowBytes)
+        {
+            const uint8_t filter = static_cast<uint8_t>(data[at]);
+            for (size_t i = 0; i < rowBytes; i++)
+            {
+                const int raw = static_cast<uint8_t>(data[at + 1 + i]);
+                const int left = i >= pixelBytes ? row[i - pixelBytes] : 0, up = previous[i], upLeft = i >= pixelBytes ? previous[i - pixelBytes] : 0;
+                int predicted = 0;
+                switch (filter)
+                {
+                case 0: break;
+                case 1: predicted = left; break;
+                case 2: predicted = up; break;
+                case 3: predicted = (left + up) / 2; break;
+                case 4:
+                {
+                    const int estimate = left + up - upLeft, toLeft = std::abs(estimate - left), toUp = std::abs(estimate - up), toUpLeft = std::abs(estimate - upLeft);
+                    predicted = toLeft <= toUp && toLeft <= toUpLeft ? left : toUp <= toUpLeft ? up : upLeft;
+                    break;
+                }
+                default: return false;
+                }
+                row[i] = static_cast<uint8_t>(raw + predicted);
+            }
+            decoded.append(reinterpret_cast<const char*>(row.data()), row.size());
+            std::swap(previous, row);
+        }
+        data = std::move(decoded);
+        return true;
+    }
+    static std::string decodeASCII85(std::string_view text)
+    {
+        std::string bytes{};
+        if (text.starts_with("<~")) text.remove_prefix(2);
+        uint32_t tuple = 0;
+        int count = 0;
+        const auto flush = [&](int keep) { for (int i = 0; i < keep; i++) bytes.push_back(static_cast<char>(tuple >> (24 - 8 * i))); };
+        for (const char c : text)
+        {
+            if (c == '~') break;
+            if (c == 'z' && count == 0) bytes.append(4, '\0');
+            if (c < '!' || c > 'u') continue;
+            tuple = tuple * 85 + static_cast<uint32_t>(c - '!');
+            if (++count < 5) continue;
+            flush(4);
+            tuple = 0;
+            count = 0;
+        }
+        if (count > 1) // A partial group is padded with 'u'
+        {
+            for (int i = count; i < 5; i++) tuple = tuple * 85 + 84;
+            flush(count - 1);
+        }
+        return bytes;
+    }
+
+    static void appendUTF8(uint32_t codePoint, std::string& text)
+    {
+        if (codePoint < 0x80) text.push_back(static_cast<char>(codePoint));
+        else if (codePoint < 0x800)
+        {
+            text.push_back(static_cast<char>(0xC0 | codePoint >> 6));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            text.push_back(static_cast<char>(0xE0 | codePoint >> 12));
+            text.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            text.push_back(static_cast<char>(0xF0 | codePoint >> 18));
+            text.push_back(static_cast<char>(0x80 | (codePoint >> 12 & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+    static std::string fromUTF16(const std::vector<uint16_t>& units)
+    {
+        std::string text{};
+        for (size_t i = 0; i < units.size(); i++)
+        {
+            uint32_t codePoint = units[i];
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 1 < units.size() && units[i + 1] >= 0xDC00 && units[i + 1] < 0xE000)
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (units[++i] - 0xDC00);
+            appendUTF8(codePoint, text);
+        }
+        return text;
+    }
+    static std::vector<uint16_t> toUnits(std::string_view bytes) // UTF-16BE
+    {
+        std::vector<uint16_t> units{};
+        for (size_t i = 0; i + 1 < bytes.size(); i += 2) units.push_back(static_cast<uint16_t>(static_cast<uint8_t>(bytes[i]) << 8 | static_cast<uint8_t>(bytes[i + 1])));
+        return units;
+    }
+    static uint32_t toCode(std::string_view bytes)
+    {
+        uint32_t code = 0;
+        for (const char c : bytes.substr(0, 4)) code = code << 8 | static_cast<uint8_t>(c);
+        return code;
+    }
+    static void parseCMap(std::string_view cmap, Font& font) // bfchar and bfrange sections of a ToUnicode CMap
+    {
+        PDFParser parser{ cmap };
+        std::vector<PDFObject> operands{};
+        bool spaced = false;
+        while (!parser.atEnd())
+        {
+            PDFObject token = parser.parseObject();
+            const auto word = token.as<PDFObject::Keyword>();
+            if (!word)
+            {
+                operands.push_back(std::move(token));
+                continue;
+            }
+            if (word->value == "endcodespacerange" && !operands.empty() && operands[0].as<std::string>())
+            {
+                font.codeBytes = std::clamp<size_t>(operands[0].as<std::string>()->size(), 1, 4);
+                spaced = true;
+            }
+            else if (word->value == "endbfchar")
+                for (size_t i = 0; i + 1 < operands.size(); i += 2)
+                {
+                    const auto source = operands[i].as<std::string>(), target = operands[i + 1].as<std::string>();
+                    if (!source || !target) continue;
+                    if (!spaced) font.codeBytes = std::clamp<size_t>(source->size(), 1, 4);
+                    font.unicode[toCode(*source)] = fromUTF16(toUnits(*target));
+                }
+            else if (word->value == "endbfrange")
+                for (size_t i = 0; i + 2 < operands.size(); i += 3)
+                {
+                    const auto low = operands[i].as<std::string>(), high = operands[i + 1].as<std::string>();
+                    if (!low || !high) continue;
+                    if (!spaced) font.codeBytes = std::clamp<size_t>(low->size(), 1, 4);
+                    const uint32_t first = toCode(*low), last = std::min(toCode(*high), first + 0xFFFF);
+                    const auto start = operands[i + 2].as<std::string>();
+                    const auto each = operands[i + 2].as<PDFObject::Array>();
+                    for (uint32_t code = first; code <= last && code >= first; code++)
+                        if (start) // Consecutive codes map to consecutive values of the last unit
+                        {
+                            std::vector<uint16_t> units = toUnits(*start);
+                            if (!units.empty()) units.back() = static_cast<uint16_t>(units.back() + (code - first));
+                            font.unicode[code] = fromUTF16(units);
+                        }
+                        else if (each && code - first < each->size() && (*each)[code - first].as<std::string>())
+                            font.unicode[code] = fromUTF16(toUnits(*(*each)[code - first].as<std::string>()));
+                }
+            operands.clear();
+        }
+    }
+    const Font* loadFont(const PDFObject& fontResources, const PDFObject* name)
+    {
+        const auto key = name ? name->as<PDFObject::Name>() : nullptr;
+        const PDFObject* entry = key ? fontResources.get(key->value) : nullptr;
+        if (!entry) return nullptr;
+        const auto reference = entry->as<PDFObject::Reference>();
+        const uint32_t number = reference ? reference->number : 0; // Direct font dictionaries share slot 0
+        if (reference)
+            if (const auto found = this->fonts.find(number); found != this->fonts.end()) return &found->second;
+        Font font{};
+        const PDFObject dictionary = this->resolve(entry);
+        if (dictionary.get("Subtype") && dictionary.get("Subtype")->isName("Type0")) font.codeBytes = 2;
+        const PDFObject toUnicode = this->resolve(dictionary.get("ToUnicode"));
+        std::string cmap{};
+        if (this->decodeStream(toUnicode, cmap)) parseCMap(cmap, font);
+        return &(this->fonts[number] = std::move(font));
+    }
+    static void appendShown(std::string_view bytes, const Font* font, std::string& text)
+    {
+        static constexpr uint16_t WinAnsi[32]{ 0x20AC, 0, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0, 0x017D, 0,
+            0, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0, 0x017E, 0x0178 };
+        if (font && !font->unicode.empty())
+        {
+            for (size_t i = 0; i + font->codeBytes <= bytes.size(); i += font->codeBytes)
+                if (const auto found = font->unicode.find(toCode(bytes.substr(i, font->codeBytes))); found != font->unicode.end()) text += found->second;
+            return;
+        }
+        if (font && font->codeBytes > 1) return; // Composite font without ToUnicode: the codes are glyph ids
+        for (const char c : bytes) // Simple fonts without a map: assume the standard Latin text encoding
+        {
+            const uint8_t code = static_cast<uint8_t>(c);
+            if (code >= 0x80 && code < 0xA0 && WinAnsi[code - 0x80]) appendUTF8(WinAnsi[code - 0x80], text);
+            else if (code >= 0x20 && code != 0x7F && (code < 0x80 || code >= 0xA0)) appendUTF8(code, text);
+        }
+    }
+    static void separate(std::string& text, char separator) // At most one space or line break between runs
+    {
+        if (text.empty()) return;
+        if (separator == '\n' && text.back() == ' ') text.back() = '\n';
+        else if (text.back() != ' ' && text.back() != '\n') text.push_back(separator);
+    }
+    void extractText(std::string_view content, const PDFObject& resources, std::string& text)
+    {
+        const PDFObject fontResources = this->resolve(resources.get("Font"));
+        const Font* font = nullptr;
+        double lineY = 0;
+        std::vector<PDFObject> operands{};
+        PDFParser parser{ content };
+        while (!parser.atEnd())
+        {
+            PDFObject token = parser.parseObject();
+            const auto word = token.as<PDFObject::Keyword>();
+            if (!word)
+            {
+                if (operands.size() < 64) operands.push_back(std::move(token));
+                continue;
+            }
+            const std::string_view op = word->value;
+            const PDFObject* last = operands.empty() ? nullptr : &operands.back();
+            if (op == "Tj" && last && last->as<std::string>()) appendShown(*last->as<std::string>(), font, text);
+            else if ((op == "'" || op == "\"") && last && last->as<std::string>())
+            {
+                separate(text, '\n');
+                appendShown(*last->as<std::string>(), font, text);
+            }
+            else if (op == "TJ" && last && last->as<PDFObject::Array>())
+            {
+                for (const auto& item : *last->as<PDFObject::Array>())
+                    if (const auto shown = item.as<std::string>()) appendShown(*shown, font, text);
+                    else if (item.number() < -200) separate(text, ' '); // A wide negative adjustment is a word gap
+            }
+            else if ((op == "Td" || op == "TD") && operands.size() >= 2) separate(text, operands[1].number() != 0 ? '\n' : ' ');
+            else if (op == "T*") separate(text, '\n');
+            else if (op == "Tm" && operands.size() >= 6)
+            {
+                separate(text, operands[5].number() != lineY ? '\n' : ' ');
+                lineY = operands[5].number();
+            }
+            else if (op == "Tf" && !operands.empty()) font = this->loadFont(fontResources, &operands[0]);
+            else if (op == "ID") // Inline image data runs up to a standalone EI
+            {
+                const std::string_view bytes = parser.getBytes();
+                size_t at = parser.getPosition() + 1;
+                while (at + 2 <= bytes.size() && !(bytes[at] == 'E' && bytes[at + 1] == 'I' && PDFParser::isSpace(bytes[at - 1])
+                    && (at + 2 == bytes.size() || PDFParser::isSpace(bytes[at + 2])))) at++;
+                parser.setPosition(std::min(at + 2, bytes.size()));
+            }
+            operands.clear();
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\n')) text.pop_back();
+    }
+protected:
+    std::unique_ptr<std::FILE, int(*)(std::FILE*)> file{ nullptr, &std::fclose };
+    uint64_t fileSize = 0;
+    std::vector<XrefEntry> xref;
+    PDFObject trailer;
+    std::unordered_map<uint32_t, PDFObject> objects; // Bounded cache: resources and fonts are shared between pages
+    std::unordered_map<uint32_t, ObjectStream> objectStreams;
+    std::unordered_map<uint32_t, Font> fonts;
+    std::vector<Frame> pages; // Depth-first walk of the page tree
+    std::unordered_set<uint32_t> visited; // Intermediate page tree nodes
+    size_t pageCount = 0;
+    uint64_t peakBuffer = 0;
 };
 
 class PDFDataMiner
     :public DataMiner
 {
+public:
+    struct Summary
+    {
+        size_t pages = 0;
+        size_t words = 0;
+        size_t characters = 0; // UTF-8 bytes
+        std::string firstLine;
+    };
 public:
     bool readData(std::string_view filePath) override
     {
         auto suffix = filePath.rfind('.');
-        if (filePath.substr(suffix + 1) != "pdf")
+        if (!this->identified && filePath.substr(suffix + 1) != "pdf")
+        {
+            *this->errors << "Not a PDF file\n";
+            return false;
+        }
+        std::string error{};
+        if (!this->document.open(std::filesystem::path{ filePath }, error))
         {
-            std::cerr << "Not a PDF file\n";
+            *this->errors << std::format("Failed to read the PDF file: {}\n", error);
             return false;
         }
-        this->data = "The data read from the specific PDF file";
         return true;
     }
-    void analyze() override
+    void analyze() override // One page at a time, so memory follows the largest page rather than the document
+    {
+        this->summary = Summary{};
+        std::string text{};
+        while (this->document.nextPage(text))
+            this->analyzePage(this->summary.pages++, text);
+        *this->output << std::format("[Analyze PDF] >> {} pages, {} words, {} characters, first line: {}\n",
+            this->summary.pages, this->summary.words, this->summary.characters, this->summary.firstLine);
+    }
+
+    virtual void analyzePage(size_t /*page*/, std::string_view text) // Override to use the text itself; it is only valid during the call
     {
-        std::cout << std::format("[Analyze PDF] >> {}\n", this->data);
+        this->summary.characters += text.size();
+        bool inWord = false;
+        for (const char c : text)
+        {
+            const bool space = c == ' ' || c == '\n';
+            this->summary.words += !space && !inWord;
+            inWord = !space;
+        }
+        if (this->summary.firstLine.empty()) this->summary.firstLine = text.substr(0, text.find('\n'));
     }
+
+    const Summary& getSummary() const { return this->summary; }
+    const PDFDocument& getDocument() const { return this->document; }
 protected:
-    std::string data;
+    PDFDocument document;
+    Summary summary;
 };
 
 class CSVDataMiner
     :public DataMiner
 {
+public:
+    struct Summary
+    {
+        size_t records = 0;
+        size_t fields = 0;
+        std::string header;
+    };
 public:
     bool readData(std::string_view filePath) override
     {
         auto suffix = filePath.rfind('.');
-        if (filePath.substr(suffix + 1) != "csv")
+        if (!this->identified && filePath.substr(suffix + 1) != "csv")
+        {
+            *this->errors << "Not a CSV file\n";
+            return false;
+        }
+        this->source = std::filesystem::path{ filePath };
+        this->cached = false;
+        this->file = MappedFile{};
+        if (this->pipeline) // Streaming reads the file itself
+        {
+            if (std::filesystem::is_regular_file(this->source)) return true;
+            *this->errors << "Failed to open the CSV file\n";
+            return false;
+        }
+        if (this->caching)
         {
-            std::cerr << "Not a CSV file\n";
+            if (this->verifyHash) this->file = MappedFile{ this->source };
+            this->cached = this->cache.open(cachePath(this->source), ColumnarCache::Stamp::of(this->source, this->file.view()));
+            if (this->cached) return true;
+        }
+        if (!this->file.isOpen()) this->file = MappedFile{ this->source };
+        if (!this->file.isOpen())
+        {
+            *this->errors << "Failed to open the CSV file\n";
             return false;
         }
-        this->data = "The data read from the specific CSV file";
         return true;
     }
     void analyze() override
     {
-        std::cout << std::format("[Analyze CSV] >> {}\n", this->data);
+        this->summary = Summary{};
+        if (this->cached)
+            this->analyzeColumns(this->cache, this->summary);
+        else this->tokenizer.tokenize(this->file.view(), [this](std::span<const std::string_view> record) { this->analyzeRecord(record, this->summary); });
+        this->report();
+        this->storeCache();
+    }
+    virtual void analyzeRecord(std::span<const std::string_view> record, Summary& summary) // Views into the mapped file, valid during analysis
+    {
+        if (summary.records++ == 0 && summary.header.empty())
+            for (auto field : record)
+                summary.header += std::format("{}[{}]", summary.header.empty() ? "" : " ", CSVTokenizer::trimQuotes(field));
+        summary.fields += record.size();
+    }
+    virtual void analyzeColumns(const ColumnarCache& table, Summary& summary) // Takes the place of analyzeRecord() when the cache is valid
+    {
+        summary.records = table.countRows() + 1;
+        summary.fields = summary.records * table.countColumns();
+        for (size_t i = 0; i < table.countColumns(); i++)
+            summary.header += std::format("{}[{}]", i == 0 ? "" : " ", table.getColumn(i).name);
+    }
+
+    void setCaching(bool enabled, bool verifyHash = false) // verifyHash also rejects caches of sources changed within the same mtime
+    {
+        this->caching = enabled;
+        this->verifyHash = verifyHash;
+    }
+    bool isCached() const { return this->cached; }
+
+    void setStreaming(std::optional<Pipeline> pipeline) { this->pipeline = pipeline; } // Takes precedence over chunks and the cache
+    std::optional<Pipeline> hook_StreamPipeline() const override { return this->pipeline; }
+    void hook_BeginStream() override { this->summary = Summary{}; }
+    size_t analyzeStream(std::string_view bytes, bool last) override
+    {
+        auto onRecord = [this](std::span<const std::string_view> record) { this->analyzeRecord(record, this->summary); };
+        if (last)
+        {
+            this->tokenizer.tokenize(bytes, onRecord);
+            return bytes.size();
+        }
+        return this->tokenizer.tokenizeComplete(bytes, onRecord);
+    }
+    void hook_EndStream() override { this->report(); }
+    const ColumnarCache& getCache() const { return this->cache; }
+    static std::filesystem::path cachePath(const std::filesystem::path& source) { return std::filesystem::path{ source } += ".dmcache"; }
+
+    void setParallelism(size_t chunks) { this->parallelism = chunks; } // 1 keeps the single-threaded analyze()
+    size_t hook_ParallelChunks() const override { return this->parallelism; }
+    std::string_view hook_ChunkableData() const override { return this->cached ? std::string_view{} : this->file.view(); }
+    std::vector<size_t> hook_SplitRecords(std::string_view data, size_t chunks) const override // Skips newlines inside quoted fields
+    {
+        std::vector<size_t> quotes(chunks); // Quote parity at every even split comes from counting quotes in parallel
+        parallelFor(chunks, [&](size_t i) { quotes[i] = std::count(data.begin() + data.size() * i / chunks, data.begin() + data.size() * (i + 1) / chunks, '"'); });
+
+        std::vector<size_t> cuts(chunks + 1, data.size());
+        cuts[0] = 0;
+        bool inside = false;
+        for (size_t i = 1; i < chunks; i++)
+        {
+            inside ^= quotes[i - 1] & 1;
+            size_t position = data.size() * i / chunks;
+            for (bool quoted = inside; position < data.size() && (quoted || data[position] != '\n'); position++)
+                if (data[position] == '"') quoted = !quoted;
+            cuts[i] = std::max(std::min(position + 1, data.size()), cuts[i - 1]);
+        }
+        return cuts;
+    }
+    void hook_BeginChunks(size_t chunks) override { this->partials.assign(chunks, Summary{}); }
+    void analyzeChunk(size_t chunk, std::string_view data) override
+    {
+        Summary& partial = this->partials[chunk];
+        this->tokenizer.tokenize(data, [&](std::span<const std::string_view> record) { this->analyzeRecord(record, partial); });
+    }
+    void hook_MergeChunks(size_t /*chunks*/) override
+    {
+        this->summary = Summary{ .header = this->partials.front().header }; // Only the first chunk starts with the header
+        for (const Summary& partial : this->partials)
+        {
+            this->summary.records += partial.records;
+            this->summary.fields += partial.fields;
+        }
+        this->report();
+        this->storeCache();
+    }
+protected:
+    void report() const
+    {
+        *this->output << std::format("[Analyze CSV] >> {} records, {} fields, header: {}{}\n", this->summary.records, this->summary.fields, this->summary.header,
+            this->cached ? " (columnar cache)" : "");
+    }
+    void storeCache()
+    {
+        if (!this->caching || this->cached) return;
+        const std::string_view text = this->file.view();
+        if (ColumnarCache::build(text, this->tokenizer, cachePath(this->source), ColumnarCache::Stamp::of(this->source, text)))
+            this->cached = this->cache.open(cachePath(this->source), ColumnarCache::Stamp::of(this->source));
+    }
+protected:
+    MappedFile file;
+    CSVTokenizer tokenizer;
+    Summary summary;
+    size_t parallelism = 1;
+    std::vector<Summary> partials;
+    std::filesystem::path source;
+    ColumnarCache cache;
+    bool caching = false;
+    bool verifyHash = false;
+    bool cached = false;
+    std::optional<Pipeline> pipeline;
+};
+
+class MinerRegistry // Picks a miner for a file by its extension, confirmed or overruled by sniffing its first bytes
+{
+public:
+    using Factory = std::function<std::unique_ptr<DataMiner>()>;
+    using Sniffer = std::function<bool(std::string_view head)>;
+
+    static constexpr size_t SniffBytes = 4096;
+public:
+    void add(std::string name, std::vector<std::string> extensions, Sniffer sniffer, Factory factory)
+    {
+        this->entries.push_back(Entry{ std::move(name), std::move(extensions), std::move(sniffer), std::move(factory) });
+    }
+
+    static MinerRegistry withBuiltins()
+    {
+        MinerRegistry registry{};
+        registry.add("PDF", { "pdf" }, [](std::string_view head) { return head.starts_with("%PDF-"); },
+            [] { return std::make_unique<PDFDataMiner>(); });
+        registry.add("CSV", { "csv" }, [](std::string_view head) // Text whose first line has a delimiter
+            {
+                const std::string_view line = head.substr(0, head.find('\n'));
+                return head.find('\0') == std::string_view::npos && line.find(',') != std::string_view::npos;
+            },
+            [] { return std::make_unique<CSVDataMiner>(); });
+        return registry;
+    }
+
+    const std::string* identify(const std::filesystem::path& path) const // Name of the chosen miner, nullptr when none fits
+    {
+        const Entry* entry = this->find(path);
+        return entry ? &entry->name : nullptr;
+    }
+    std::unique_ptr<DataMiner> create(const std::filesystem::path& path, std::string* chosen = nullptr) const // chosen receives the miner name
+    {
+        const Entry* entry = this->find(path);
+        if (!entry) return nullptr;
+        if (chosen) *chosen = entry->name;
+        auto miner = entry->factory();
+        miner->markIdentified();
+        return miner;
     }
 protected:
-    std::string data;
+    struct Entry
+    {
+        std::string name;
+        std::vector<std::string> extensions;
+        Sniffer sniffer;
+        Factory factory;
+    };
+
+    const Entry* find(const std::filesystem::path& path) const
+    {
+        std::string extension = path.extension().string();
+        if (!extension.empty()) extension.erase(0, 1);
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        const Entry* byExtension = nullptr;
+        for (const auto& entry : this->entries)
+            if (std::ranges::find(entry.extensions, extension) != entry.extensions.end()) byExtension = byExtension ? byExtension : &entry;
+
+        std::string head(SniffBytes, '\0');
+        std::ifstream input{ path, std::ios::binary };
+        input.read(head.data(), static_cast<std::streamsize>(head.size()));
+        head.resize(static_cast<size_t>(input.gcount()));
+        if (head.empty()) return byExtension; // Unreadable or empty: the extension is all there is
+        if (byExtension && byExtension->sniffer(head)) return byExtension;
+        for (const auto& entry : this->entries)
+            if (entry.sniffer(head)) return &entry;
+        return nullptr;
+    }
+protected:
+    std::vector<Entry> entries;
+};
+
+class BatchMiner // Mines every file of a directory tree on a worker pool, largest files first to shorten the straggler tail
+{
+public:
+    struct FileReport
+    {
+        std::filesystem::path path;
+        std::string miner; // Empty when no miner fits
+        std::string output; // What the miner printed, collected per file so workers do not interleave on the console
+        uint64_t bytes = 0;
+        std::chrono::duration<double> seconds{};
+        bool succeeded = false;
+    };
+
+    struct Report
+    {
+        std::vector<FileReport> files; // Largest first
+        uint64_t bytes = 0; // Of the mined files
+        std::chrono::duration<double> elapsed{};
+        size_t mined = 0;
+        size_t failed = 0;
+        size_t skipped = 0;
+
+        double throughput() const { return elapsed.count() > 0 ? this->bytes / elapsed.count() : 0.0; } // Bytes per second
+        void print(std::ostream& output) const
+        {
+            for (const auto& file : this->files)
+            {
+                output << std::format("{:>8} {:>12} B {:>10.3f} ms  {}\n", file.miner.empty() ? "-" : file.miner,
+                    file.bytes, file.seconds.count() * 1e3, file.path.string());
+                output << file.output;
+            }
+            output << std::format("{} mined, {} failed, {} skipped, {} B in {:.3f} s ({:.1f} MB/s)\n",
+                this->mined, this->failed, this->skipped, this->bytes, this->elapsed.count(), this->throughput() / 1e6);
+        }
+    };
+public:
+    explicit BatchMiner(const MinerRegistry& registry, size_t threads = std::thread::hardware_concurrency()) :
+        registry{ registry }, threads{ std::max<size_t>(threads, 1) } { };
+public:
+    Report run(const std::filesystem::path& root) const
+    {
+        Report report{};
+        std::error_code error{};
+        for (std::filesystem::recursive_directory_iterator it{ root, std::filesystem::directory_options::skip_permission_denied, error }, end{};
+            it != end; it.increment(error))
+        {
+            if (it->is_regular_file(error) && it->path().extension() != ".dmcache" && it->path().extension() != ".tmp")
+                report.files.push_back(FileReport{ .path = it->path(), .miner = {}, .output = {}, .bytes = it->file_size(error), .seconds = {}, .succeeded = false });
+        }
+        std::ranges::stable_sort(report.files, std::greater{}, &FileReport::bytes); // Longest processing time first
+
+        const auto begin = std::chrono::steady_clock::now();
+        std::atomic<size_t> next{ 0 };
+        parallelFor(std::min(this->threads, std::max<size_t>(report.files.size(), 1)), [&](size_t)
+        {
+            for (size_t i; (i = next.fetch_add(1)) < report.files.size();)
+            {
+                FileReport& file = report.files[i];
+                const auto started = std::chrono::steady_clock::now();
+                if (auto miner = this->registry.create(file.path, &file.miner))
+                {
+                    std::ostringstream output{};
+                    miner->setOutput(output, output);
+                    file.succeeded = miner->mine(file.path.string());
+                    file.output = std::move(output).str();
+                }
+                file.seconds = std::chrono::steady_clock::now() - started;
+            }
+        });
+        report.elapsed = std::chrono::steady_clock::now() - begin;
+
+        for (const auto& file : report.files)
+        {
+            if (file.miner.empty()) report.skipped++;
+            else if (!file.succeeded) report.failed++;
+            else
+            {
+                report.mined++;
+                report.bytes += file.bytes;
+            }
+        }
+        return report;
+    }
+protected:
+    const MinerRegistry& registry;
+    size_t threads;
 };
 
+std::filesystem::path writeSampleCSV(const std::filesystem::path& path, size_t bytes) // Quoted fields hold no delimiters, so a naive split agrees
+{
+    std::mt19937 random{ 1 };
+    std::ofstream output{ path, std::ios::binary };
+    std::string line{};
+    output << "id,name,city,amount,note\n";
+    for (size_t written = 0, id = 0; written < bytes; written += line.size(), id++)
+    {
+        line = std::format("{},\"user{}\",{},{}.{:02},\"{}\"\n", id, random() % 100000, random() % 2 ? "Seoul" : "Lisbon",
+            random() % 10000, random() % 100, std::string(random() % 40, 'x'));
+        output << line;
+    }
+    return path;
+}
+
+std::string deflateStored(std::string_view bytes) // zlib framing around stored blocks: valid FlateDecode data without a compressor
+{
+    std::string framed{ "\x78\x01", 2 };
+    size_t at = 0;
+    do
+    {
+        const size_t length = std::min<size_t>(bytes.size() - at, 65535);
+        const char header[5]{ static_cast<char>(at + length == bytes.size()), static_cast<char>(length & 0xFF), static_cast<char>(length >> 8),
+            static_cast<char>(~length & 0xFF), static_cast<char>(~length >> 8 & 0xFF) };
+        framed.append(header, sizeof(header));
+        framed.append(bytes.substr(at, length));
+        at += length;
+    } while (at < bytes.size());
+    uint32_t low = 1, high = 0; // Adler-32
+    for (const char c : bytes)
+    {
+        low = (low + static_cast<uint8_t>(c)) % 65521;
+        high = (high + low) % 65521;
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) framed.push_back(static_cast<char>((high << 16 | low) >> shift));
+    return framed;
+}
+
+std::filesystem::path writeSamplePDF(const std::filesystem::path& path, size_t pages, size_t linesPerPage) // Two-level page tree, fonts inherited from the root
+{
+    constexpr size_t PagesPerNode = 64;
+    const size_t nodes = (pages + PagesPerNode - 1) / PagesPerNode;
+    const auto page = [&](size_t index) { return 4 + nodes + 2 * index; }; // Its content stream is the next object
+    std::vector<uint64_t> offsets(4 + nodes + 2 * pages, 0);
+    std::ofstream output{ path, std::ios::binary };
+    const auto object = [&](size_t number, std::string_view body)
+    {
+        offsets[number] = static_cast<uint64_t>(output.tellp());
+        output << number << " 0 obj\n" << body << "\nendobj\n";
+    };
+    std::mt19937 random{ 7 };
+    output << "%PDF-1.4\n";
+    object(1, "<< /Type /Catalog /Pages 2 0 R >>");
+    std::string kids{};
+    for (size_t node = 0; node < nodes; node++) kids += std::format("{} 0 R ", 4 + node);
+    object(2, std::format("<< /Type /Pages /Kids [{}] /Count {} /Resources << /Font << /F1 3 0 R >> >> >>", kids, pages));
+    object(3, "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+    for (size_t node = 0; node < nodes; node++)
+    {
+        kids.clear();
+        const size_t last = std::min(pages, (node + 1) * PagesPerNode);
+        for (size_t index = node * PagesPerNode; index < last; index++) kids += std::format("{} 0 R ", page(index));
+        object(4 + node, std::format("<< /Type /Pages /Parent 2 0 R /Kids [{}] /Count {} >>", kids, last - node * PagesPerNode));
+    }
+    for (size_t index = 0; index < pages; index++)
+    {
+        std::string content = std::format("BT /F1 11 Tf 72 760 Td (Quarterly report, page {}) Tj", index + 1);
+        for (size_t line = 0; line < linesPerPage; line++)
+            content += std::format(" 0 -13 Td [(Region) -250 ({}) -250 (sold) -250 ({} units)] TJ", random() % 2 ? "Seoul" : "Lisbon", random() % 10000);
+        const std::string stream = deflateStored(content + " ET");
+        object(page(index), std::format("<< /Type /Page /Parent {} 0 R /MediaBox [0 0 612 792] /Contents {} 0 R >>", 4 + index / PagesPerNode, page(index) + 1));
+        object(page(index) + 1, std::format("<< /Length {} /Filter /FlateDecode >>\nstream\n{}\nendstream", stream.size(), stream));
+    }
+    const uint64_t xref = static_cast<uint64_t>(output.tellp());
+    output << std::format("xref\n0 {}\n0000000000 65535 f\r\n", offsets.size());
+    for (size_t number = 1; number < offsets.size(); number++) output << std::format("{:010} 00000 n\r\n", offsets[number]);
+    output << std::format("trailer\n<< /Size {} /Root 1 0 R >>\nstartxref\n{}\n%%EOF\n", offsets.size(), xref);
+    return path;
+}
+
+void benchmarkCSV()
+{
+    const auto path = writeSampleCSV(std::filesystem::temp_directory_path() / "datamining-bench.csv", 256 << 20);
+    const double gigabytes = std::filesystem::file_size(path) / 1e9;
+
+    auto begin = std::chrono::steady_clock::now();
+    size_t naiveFields{ 0 };
+    {
+        std::ifstream input{ path };
+        std::string line{};
+        std::vector<std::string> fields{};
+        while (std::getline(input, line))
+        {
+            fields.clear();
+            size_t from{ 0 };
+            for (size_t comma; (comma = line.find(',', from)) != std::string::npos; from = comma + 1)
+                fields.emplace_back(line.substr(from, comma - from));
+            fields.emplace_back(line.substr(from));
+            naiveFields += fields.size();
+        }
+    }
+    const double naiveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << std::format("[getline + split ] {:.2f} GB/s, {} fields\n", gigabytes / naiveSeconds, naiveFields);
+
+    for (const bool vectorized : { false, true })
+    {
+        begin = std::chrono::steady_clock::now();
+        MappedFile file{ path };
+        size_t fields{ 0 };
+        CSVTokenizer{ ',', vectorized }.tokenize(file.view(), [&](std::span<const std::string_view> record) { fields += record.size(); });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << std::format("[mmap + {} ] {:.2f} GB/s, {} fields\n", vectorized ? "SIMD     " : "scalar   ", gigabytes / seconds, fields);
+    }
+    std::filesystem::remove(path);
+}
+
+void benchmarkColumnarCache()
+{
+    const auto path = writeSampleCSV(std::filesystem::temp_directory_path() / "datamining-cache.csv", 256 << 20);
+    std::filesystem::remove(CSVDataMiner::cachePath(path));
+    struct Run
+    {
+        std::string_view name;
+        bool verifyHash;
+    };
+    for (const Run run : { Run{ "Cold (parse + build)", false }, Run{ "Warm (mapped cache) ", false }, Run{ "Warm + source hash  ", true } })
+    {
+        CSVDataMiner miner{};
+        miner.setCaching(true, run.verifyHash);
+        const auto begin = std::chrono::steady_clock::now();
+        miner.mine(path.string());
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << std::format("[{}] {:.3f} ms\n", run.name, milliseconds);
+    }
+
+    CSVDataMiner miner{};
+    miner.setCaching(true);
+    miner.readData(path.string());
+    const auto& table = miner.getCache();
+    const auto begin = std::chrono::steady_clock::now();
+    const auto range = table.countInRange(table.findColumn("id").value(), 0, 100'000);
+    const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << std::format("[Range scan on id   ] {:.3f} ms, {} rows, {} row groups skipped\n", milliseconds, range.rows, range.skippedGroups);
+    std::filesystem::remove(CSVDataMiner::cachePath(path));
+    std::filesystem::remove(path);
+}
+
+void benchmarkPipeline()
+{
+    const auto path = writeSampleCSV(std::filesystem::temp_directory_path() / "datamining-pipeline.csv", 256 << 20);
+    const double gigabytes = std::filesystem::file_size(path) / 1e9;
+    const DataMiner::Pipeline pipelines[]{ { 1, 1 << 20 }, { 2, 64 << 10 }, { 2, 1 << 20 }, { 4, 1 << 20 }, { 8, 4 << 20 } };
+    for (const auto& pipeline : pipelines)
+    {
+        CSVDataMiner miner{};
+        miner.setStreaming(pipeline);
+        miner.mine(path.string());
+        const auto& stats = miner.getPipelineStats();
+        std::cout << std::format("[{} x {:>4} KiB] {:.2f} GB/s, reader busy {:>3.0f}%, analyzer busy {:>3.0f}%, {} buffers\n",
+            pipeline.buffers, pipeline.bufferBytes >> 10, gigabytes / std::chrono::duration<double>(stats.elapsed).count(),
+            stats.readUtilization() * 100, stats.analyzeUtilization() * 100, stats.buffers);
+    }
+    std::filesystem::remove(path);
+}
+
+void benchmarkParallelCSV()
+{
+    const auto path = writeSampleCSV(std::filesystem::temp_directory_path() / "datamining-parallel.csv", 256 << 20);
+    const double gigabytes = std::filesystem::file_size(path) / 1e9;
+    double baseline{ 0 };
+    for (size_t chunks = 1; chunks <= 16; chunks *= 2)
+    {
+        CSVDataMiner miner{};
+        miner.setParallelism(chunks);
+        const auto begin = std::chrono::steady_clock::now();
+        miner.mine(path.string());
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (chunks == 1) baseline = seconds;
+        std::cout << std::format("[{:>2} chunks] {:.2f} GB/s, speedup {:.2f}\n", chunks, gigabytes / seconds, baseline / seconds);
+    }
+    std::filesystem::remove(path);
+}
+
+void benchmarkPDF()
+{
+    const auto path = writeSamplePDF(std::filesystem::temp_directory_path() / "datamining-bench.pdf", 1 << 16, 40);
+    const double megabytes = std::filesystem::file_size(path) / 1e6;
+    PDFDataMiner miner{};
+    const auto begin = std::chrono::steady_clock::now();
+    miner.mine(path.string());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << std::format("[PDF text extraction] {:.0f} MB/s, {} pages, largest page buffer {} KiB of a {:.0f} MB file\n",
+        megabytes / seconds, miner.getSummary().pages, miner.getDocument().getPeakBufferBytes() >> 10, megabytes);
+    std::filesystem::remove(path);
+}
+
 int main(int argc, char* argv[])
 {
-    std::string book = "A Tour of C++.pdf";
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkCSV();
+        benchmarkParallelCSV();
+        benchmarkColumnarCache();
+        benchmarkPipeline();
+        benchmarkPDF();
+        return EXIT_SUCCESS;
+    }
+
+    const MinerRegistry registry = MinerRegistry::withBuiltins();
+    if (argc > 2 && std::string_view{ argv[1] } == "--batch")
+    {
+        BatchMiner{ registry }.run(argv[2]).print(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    const auto book = writeSamplePDF(std::filesystem::temp_directory_path() / "datamining-report.pdf", 3, 2);
 
     CSVDataMiner miner_csv{};
-    PDFDataMiner miner_pdf{};
 
-    if (miner_csv.readData(book))
-        miner_csv.analyze();
-    else if (miner_pdf.readData(book))
-        miner_pdf.analyze();
+    if (auto miner = registry.create(book))
+        miner->mine(book.string());
     else std::cerr << "Failed to find a proper miner!\n";
+    std::filesystem::remove(book);
+
+    const auto sheet = writeSampleCSV(std::filesystem::temp_directory_path() / "datamining-sample.csv", 4096);
+    if (miner_csv.readData(sheet.string()))
+        miner_csv.analyze();
+    CSVDataMiner parallel_csv{};
+    parallel_csv.setParallelism(4);
+    parallel_csv.mine(sheet.string());
+
+    CSVDataMiner streaming_csv{};
+    streaming_csv.setStreaming(DataMiner::Pipeline{ .buffers = 2, .bufferBytes = 1024 });
+    streaming_csv.mine(sheet.string());
+    std::cout << std::format("Streamed {} buffers, {} bytes carried between them\n",
+        streaming_csv.getPipelineStats().buffers, streaming_csv.getPipelineStats().carriedBytes);
+
+    for (size_t run = 0; run < 2; run++) // The second run reads the columnar cache written by the first
+    {
+        CSVDataMiner cached_csv{};
+        cached_csv.setCaching(true);
+        cached_csv.mine(sheet.string());
+    }
+    CSVDataMiner cached_csv{};
+    cached_csv.setCaching(true);
+    if (cached_csv.readData(sheet.string()) && cached_csv.isCached())
+    {
+        const auto& table = cached_csv.getCache();
+        if (auto amount = table.findColumn("amount"))
+        {
+            const auto& column = table.getColumn(*amount);
+            const auto range = table.countInRange(*amount, 0, 1000);
+            std::cout << std::format("amount in [{}, {}], {} of {} rows <= 1000\n", column.min, column.max, range.rows, table.countRows());
+        }
+    }
+    std::filesystem::remove(CSVDataMiner::cachePath(sheet));
+    std::filesystem::remove(sheet);
+
+    const auto folder = std::filesystem::temp_directory_path() / "datamining-batch";
+    std::filesystem::create_directories(folder / "nested");
+    writeSampleCSV(folder / "small.csv", 2048);
+    writeSampleCSV(folder / "nested" / "large.csv", 64 << 10);
+    writeSampleCSV(folder / "export.txt", 8192); // Sniffed as CSV despite its extension
+    writeSamplePDF(folder / "nested" / "report.pdf", 8, 10);
+    std::ofstream{ folder / "notes.md" } << "# Not minable\n";
+    BatchMiner{ registry, 2 }.run(folder).print(std::cout);
+    std::filesystem::remove_all(folder);
     
     return EXIT_SUCCESS;
 }
@@ -13,6 +13,10 @@ Note: Double Dispatch is the key!
 #include <format>
 #include <vector>
 #include <memory>
+#include <tuple>
+#include <numbers>
+#include <chrono>
+#include <random>
 
 class Circle;
 class Dot;
@@ -22,12 +26,19 @@ class ShapeSensor
 public:
     void visit(Circle* circle);
     void visit(Dot* dot);
+
+    double getTotalArea() const { return this->totalArea; }
+public:
+    std::ostream* log = &std::cout; // Where measurements are reported, nullptr keeps the hot path quiet
+protected:
+    double totalArea = 0.0;
 };
 
 class Visitable 
 // If you add this properity to some class, you should overload visit() in class ShapeSensor and set class ShapeSensor as a friend.
 {
 public:
+    virtual ~Visitable() = default;
     virtual void accept(ShapeSensor* visitor) = 0; // Double Dispatch
 };
 
@@ -36,9 +47,10 @@ class Circle
 {
     friend ShapeSensor;
 public:
+    explicit Circle(double radius = 1.0) :radius{ radius } {}
     void accept(ShapeSensor* visitor) override { visitor->visit(this); }
 protected:
-    double radius = 1.0;
+    double radius;
 };
 
 class Dot
@@ -46,9 +58,10 @@ class Dot
 {
     friend ShapeSensor;
 public:
+    explicit Dot(double radius = 0.1) :radius{ radius } {}
     void accept(ShapeSensor* visitor) override { visitor->visit(this); }
 protected:
-    double radius = 0.1;
+    double radius;
 };
 
 class Canvas
@@ -63,7 +76,10 @@ public:
     void measureAllShapes() const
     {
         static ShapeSensor sensor{};
-
+        this->measureAllShapes(sensor);
+    }
+    void measureAllShapes(ShapeSensor& sensor) const
+    {
         for (auto& shape : this->shapes) 
             shape->accept(&sensor);
     }
@@ -71,24 +87,110 @@ protected:
     std::vector<std::unique_ptr<Visitable>> shapes;
 };
 
+template<typename... Shapes>
+class PartitionedCanvas // One contiguous array per concrete shape: the visitor's overload is picked at compile time, one tight loop per type
+{
+public:
+    template<typename Shape>
+    PartitionedCanvas& addShape(Shape shape)
+    {
+        std::get<std::vector<Shape>>(this->shapes).push_back(std::move(shape));
+        return *this;
+    }
+
+    template<typename Visitor>
+    void visitAll(Visitor& visitor) // Shapes come grouped by type, not in the order they were added
+    {
+        std::apply([&](auto&... arrays) { (visitEach(arrays, visitor), ...); }, this->shapes);
+    }
+    void measureAllShapes()
+    {
+        static ShapeSensor sensor{};
+        this->visitAll(sensor);
+    }
+
+    size_t size() const { return std::apply([](const auto&... arrays) { return (arrays.size() + ... + size_t{ 0 }); }, this->shapes); }
+protected:
+    template<typename Shape, typename Visitor>
+    static void visitEach(std::vector<Shape>& array, Visitor& visitor)
+    {
+        for (auto& shape : array)
+            visitor.visit(&shape); // Not accept(): the static type is already known
+    }
+protected:
+    std::tuple<std::vector<Shapes>...> shapes;
+};
+
+void benchmarkCanvas()
+{
+    constexpr size_t count = 10'000'000;
+    std::mt19937 random{ 1 };
+    std::uniform_real_distribution<double> radius{ 0.05, 2.0 };
+
+    Canvas canvas{};
+    PartitionedCanvas<Circle, Dot> partitioned{};
+    for (size_t i = 0; i < count; i++)
+        if (random() % 2)
+        {
+            const double r = radius(random);
+            canvas.addShape(std::make_unique<Circle>(r));
+            partitioned.addShape(Circle{ r });
+        }
+        else
+        {
+            const double r = radius(random) * 0.1;
+            canvas.addShape(std::make_unique<Dot>(r));
+            partitioned.addShape(Dot{ r });
+        }
+
+    ShapeSensor pointers{}, arrays{};
+    pointers.log = nullptr;
+    arrays.log = nullptr;
+    auto begin = std::chrono::steady_clock::now();
+    canvas.measureAllShapes(pointers);
+    const double pointerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    partitioned.visitAll(arrays);
+    const double arraySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << std::format("[unique_ptr + accept] {:.2f} ns/shape, area {:.3f}\n", pointerSeconds * 1e9 / count, pointers.getTotalArea());
+    std::cout << std::format("[Arrays per type    ] {:.2f} ns/shape, area {:.3f} ({} shapes, {:.1f}x)\n",
+        arraySeconds * 1e9 / count, arrays.getTotalArea(), partitioned.size(), pointerSeconds / arraySeconds);
+}
+
 int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string_view{ argv[1] } == "--bench")
+    {
+        benchmarkCanvas();
+        return EXIT_SUCCESS;
+    }
+
     Canvas canvas{};
     canvas.addShape(std::make_unique<Circle>())
           .addShape(std::make_unique<Dot>());
 
     canvas.measureAllShapes();
+
+    PartitionedCanvas<Circle, Dot> partitioned{};
+    partitioned.addShape(Circle{ 2.0 })
+               .addShape(Dot{})
+               .addShape(Circle{});
+    partitioned.measureAllShapes();
     
     return EXIT_SUCCESS;
 }
 
-void ShapeSensor::visit(Circle* circle)
+inline void ShapeSensor::visit(Circle* circle)
 {
-    std::cout << std::format("Circle Radius = {}\n", circle->radius);
+    this->totalArea += std::numbers::pi * circle->radius * circle->radius;
+    if (this->log) *this->log << std::format("Circle Radius = {}\n", circle->radius);
 }
 
-void ShapeSensor::visit(Dot* dot)
+inline void ShapeSensor::visit(Dot* dot)
 {
-    std::cout << std::format("Dot Radius = {}\n", dot->radius);
+    this->totalArea += std::numbers::pi * dot->radius * dot->radius;
+    if (this->log) *this->log << std::format("Dot Radius = {}\n", dot->radius);
 }
 